@@ -40,6 +40,8 @@ Cam CamFromIntAndViewingConditions(Argb argb,
                                    const ViewingConditions &viewing_conditions);
 Argb IntFromHcl(double hue, double chroma, double lstar);
 Argb IntFromCam(Cam cam);
+Argb IntFromCamAndViewingConditions(Cam cam,
+                                    ViewingConditions viewing_conditions);
 Cam CamFromUcsAndViewingConditions(double jstar, double astar, double bstar,
                                    const ViewingConditions &viewing_conditions);
 /**
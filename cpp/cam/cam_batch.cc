@@ -0,0 +1,527 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpp/cam/cam_batch.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "absl/types/span.h"
+#include "cpp/cam/cam.h"
+#include "cpp/cam/hct.h"
+#include "cpp/cam/viewing_conditions.h"
+#include "cpp/utils/simd.h"
+#include "cpp/utils/utils.h"
+
+#ifdef MCU_HAS_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace material_color_utilities {
+
+void CamArrays::Resize(size_t size) {
+  hue.resize(size);
+  chroma.resize(size);
+  j.resize(size);
+  q.resize(size);
+  m.resize(size);
+  s.resize(size);
+  jstar.resize(size);
+  astar.resize(size);
+  bstar.resize(size);
+}
+
+Cam CamArrays::Get(size_t index) const {
+  return {hue[index],   chroma[index], j[index],
+          q[index],     m[index],      s[index],
+          jstar[index], astar[index],  bstar[index]};
+}
+
+void HctArrays::Resize(size_t size) {
+  hue.resize(size);
+  chroma.resize(size);
+  tone.resize(size);
+}
+
+#ifdef MCU_HAS_X86_KERNELS
+
+namespace {
+
+using Constants = DefaultViewingConstants;
+
+/**
+ * The discounted cone responses r_d, g_d and b_d of CamFromInt, and the
+ * luminance y, that each value of each RGB channel contributes to a color;
+ * the terms are linear in the linearized channels, so a color's are the sum
+ * of its three channels'. Each entry is one 256-bit load.
+ */
+struct ChannelResponseTable {
+  alignas(32) double responses[3][256][4];
+
+  ChannelResponseTable() {
+    for (int channel = 0; channel < 3; channel++) {
+      for (int component = 0; component < 256; component++) {
+        double linear[3] = {0.0, 0.0, 0.0};
+        linear[channel] = Linearized(component);
+        double x = 0.41233895 * linear[0] + 0.35762064 * linear[1] +
+                   0.18051042 * linear[2];
+        double y =
+            0.2126 * linear[0] + 0.7152 * linear[1] + 0.0722 * linear[2];
+        double z = 0.01932141 * linear[0] + 0.11916382 * linear[1] +
+                   0.95034478 * linear[2];
+        double r_c = 0.401288 * x + 0.650173 * y - 0.051461 * z;
+        double g_c = -0.250268 * x + 1.204414 * y + 0.045854 * z;
+        double b_c = -0.002079 * x + 0.048952 * y + 0.953127 * z;
+        double* response = responses[channel][component];
+        response[0] = Constants::rgb_d[0] * r_c;
+        response[1] = Constants::rgb_d[1] * g_c;
+        response[2] = Constants::rgb_d[2] * b_c;
+        response[3] = y;
+      }
+    }
+  }
+
+  static const ChannelResponseTable& Get() {
+    static const ChannelResponseTable* table = new ChannelResponseTable();
+    return *table;
+  }
+};
+
+/**
+ * Evaluates the polynomial with the given coefficients, highest degree
+ * first, at x.
+ */
+template <int N>
+__attribute__((target("avx2"))) inline __m256d Avx2Polynomial(
+    __m256d x, const double (&coefficients)[N]) {
+  __m256d result = _mm256_set1_pd(coefficients[0]);
+  for (int i = 1; i < N; i++) {
+    result = _mm256_add_pd(_mm256_mul_pd(result, x),
+                           _mm256_set1_pd(coefficients[i]));
+  }
+  return result;
+}
+
+/**
+ * Converts doubles holding integers below 2^51 in magnitude to 64-bit
+ * integers.
+ */
+__attribute__((target("avx2"))) inline __m256i Avx2ToInt64(__m256d x) {
+  __m256d magic = _mm256_set1_pd(0x1.8p52);
+  return _mm256_sub_epi64(_mm256_castpd_si256(_mm256_add_pd(x, magic)),
+                          _mm256_castpd_si256(magic));
+}
+
+// ln(2), split so that multiples of the high part by small integers are
+// exact.
+constexpr double kLn2High = 6.93147180369123816490e-01;
+constexpr double kLn2Low = 1.90821492927058770002e-10;
+
+/**
+ * Natural logarithm of positive, normal numbers, within a few units in the
+ * last place.
+ */
+__attribute__((target("avx2"))) inline __m256d Avx2Log(__m256d x) {
+  // x = 2^exponent * mantissa, with the mantissa in [sqrt(1/2), sqrt(2)).
+  __m256i bits = _mm256_castpd_si256(x);
+  __m256d mantissa = _mm256_castsi256_pd(
+      _mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi64x(
+                                                  0x000fffffffffffff)),
+                      _mm256_set1_epi64x(0x3ff0000000000000)));
+  __m256d biased_exponent = _mm256_castsi256_pd(
+      _mm256_or_si256(_mm256_srli_epi64(bits, 52),
+                      _mm256_castpd_si256(_mm256_set1_pd(0x1p52))));
+  __m256d exponent =
+      _mm256_sub_pd(biased_exponent, _mm256_set1_pd(0x1p52 + 1023));
+  __m256d large =
+      _mm256_cmp_pd(mantissa, _mm256_set1_pd(1.4142135623730951), _CMP_GT_OQ);
+  mantissa = _mm256_blendv_pd(
+      mantissa, _mm256_mul_pd(mantissa, _mm256_set1_pd(0.5)), large);
+  exponent = _mm256_add_pd(exponent, _mm256_and_pd(large, _mm256_set1_pd(1.0)));
+
+  // ln(mantissa) = 2 atanh(s) = 2 (s + s^3 / 3 + s^5 / 5 + ...), where
+  // |s| < 0.172.
+  __m256d one = _mm256_set1_pd(1.0);
+  __m256d s = _mm256_div_pd(_mm256_sub_pd(mantissa, one),
+                            _mm256_add_pd(mantissa, one));
+  static constexpr double kSeries[] = {
+      1.0 / 21, 1.0 / 19, 1.0 / 17, 1.0 / 15, 1.0 / 13, 1.0 / 11,
+      1.0 / 9,  1.0 / 7,  1.0 / 5,  1.0 / 3,  1.0,
+  };
+  __m256d log_mantissa = _mm256_mul_pd(
+      _mm256_mul_pd(_mm256_set1_pd(2.0), s),
+      Avx2Polynomial(_mm256_mul_pd(s, s), kSeries));
+  return _mm256_add_pd(
+      _mm256_mul_pd(exponent, _mm256_set1_pd(kLn2High)),
+      _mm256_add_pd(_mm256_mul_pd(exponent, _mm256_set1_pd(kLn2Low)),
+                    log_mantissa));
+}
+
+/**
+ * e^x for -700 < x < 700, within a few units in the last place.
+ */
+__attribute__((target("avx2"))) inline __m256d Avx2Exp(__m256d x) {
+  // x = k ln(2) + r, with |r| <= ln(2) / 2.
+  __m256d k = _mm256_round_pd(
+      _mm256_mul_pd(x, _mm256_set1_pd(1.4426950408889634)),
+      _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  __m256d r = _mm256_sub_pd(
+      _mm256_sub_pd(x, _mm256_mul_pd(k, _mm256_set1_pd(kLn2High))),
+      _mm256_mul_pd(k, _mm256_set1_pd(kLn2Low)));
+  // The Taylor series of e^r, to r^13.
+  static constexpr double kSeries[] = {
+      1.0 / 6227020800, 1.0 / 479001600, 1.0 / 39916800, 1.0 / 3628800,
+      1.0 / 362880,     1.0 / 40320,     1.0 / 5040,     1.0 / 720,
+      1.0 / 120,        1.0 / 24,        1.0 / 6,        1.0 / 2,
+      1.0,              1.0,
+  };
+  __m256d exp_r = Avx2Polynomial(r, kSeries);
+  __m256i scale_bits = _mm256_slli_epi64(
+      _mm256_add_epi64(Avx2ToInt64(k), _mm256_set1_epi64x(1023)), 52);
+  return _mm256_mul_pd(exp_r, _mm256_castsi256_pd(scale_bits));
+}
+
+/**
+ * x^y for positive, normal x, as e^(y ln(x)).
+ */
+__attribute__((target("avx2"))) inline __m256d Avx2Pow(__m256d x, double y) {
+  return Avx2Exp(_mm256_mul_pd(_mm256_set1_pd(y), Avx2Log(x)));
+}
+
+/**
+ * Sine and cosine of x for |x| < 1e6.
+ */
+__attribute__((target("avx2"))) inline void Avx2SinCos(__m256d x,
+                                                       __m256d* sin_x,
+                                                       __m256d* cos_x) {
+  // x = k pi / 2 + r, with |r| <= pi / 4; pi / 2 is split so that multiples
+  // of the high part by k are exact.
+  __m256d k = _mm256_round_pd(
+      _mm256_mul_pd(x, _mm256_set1_pd(0.63661977236758134)),
+      _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  __m256d r = _mm256_sub_pd(
+      _mm256_sub_pd(
+          x, _mm256_mul_pd(k, _mm256_set1_pd(1.57079632673412561417e+00))),
+      _mm256_mul_pd(k, _mm256_set1_pd(6.07710050650619224932e-11)));
+  __m256d r2 = _mm256_mul_pd(r, r);
+  // The Taylor series of sin(r), to r^17, and cos(r), to r^18.
+  static constexpr double kSinSeries[] = {
+      1.0 / 355687428096000, -1.0 / 1307674368000, 1.0 / 6227020800,
+      -1.0 / 39916800,       1.0 / 362880,         -1.0 / 5040,
+      1.0 / 120,             -1.0 / 6,             1.0,
+  };
+  static constexpr double kCosSeries[] = {
+      -1.0 / 6402373705728000, 1.0 / 20922789888000, -1.0 / 87178291200,
+      1.0 / 479001600,         -1.0 / 3628800,       1.0 / 40320,
+      -1.0 / 720,              1.0 / 24,             -1.0 / 2,
+      1.0,
+  };
+  __m256d sin_r = _mm256_mul_pd(r, Avx2Polynomial(r2, kSinSeries));
+  __m256d cos_r = Avx2Polynomial(r2, kCosSeries);
+
+  // Rotate by the quadrant, k mod 4.
+  __m256i quadrant = Avx2ToInt64(k);
+  __m256i one = _mm256_set1_epi64x(1);
+  __m256i two = _mm256_set1_epi64x(2);
+  __m256d swap = _mm256_castsi256_pd(
+      _mm256_cmpeq_epi64(_mm256_and_si256(quadrant, one), one));
+  __m256d negate_sin = _mm256_castsi256_pd(
+      _mm256_cmpeq_epi64(_mm256_and_si256(quadrant, two), two));
+  __m256d negate_cos = _mm256_castsi256_pd(_mm256_cmpeq_epi64(
+      _mm256_and_si256(_mm256_add_epi64(quadrant, one), two), two));
+  __m256d sign = _mm256_set1_pd(-0.0);
+  *sin_x = _mm256_xor_pd(_mm256_blendv_pd(sin_r, cos_r, swap),
+                         _mm256_and_pd(negate_sin, sign));
+  *cos_x = _mm256_xor_pd(_mm256_blendv_pd(cos_r, sin_r, swap),
+                         _mm256_and_pd(negate_cos, sign));
+}
+
+/**
+ * atan2(y, x), in radians; 0 where both are 0.
+ */
+__attribute__((target("avx2"))) inline __m256d Avx2Atan2(__m256d y,
+                                                         __m256d x) {
+  __m256d sign = _mm256_set1_pd(-0.0);
+  __m256d zero = _mm256_setzero_pd();
+  __m256d one = _mm256_set1_pd(1.0);
+  __m256d abs_x = _mm256_andnot_pd(sign, x);
+  __m256d abs_y = _mm256_andnot_pd(sign, y);
+  // The angle of (max, min) is in [0, pi / 4]; z is its tangent.
+  __m256d swap = _mm256_cmp_pd(abs_y, abs_x, _CMP_GT_OQ);
+  __m256d numerator = _mm256_min_pd(abs_x, abs_y);
+  __m256d denominator = _mm256_max_pd(abs_x, abs_y);
+  __m256d z = _mm256_and_pd(
+      _mm256_cmp_pd(denominator, zero, _CMP_GT_OQ),
+      _mm256_div_pd(numerator, _mm256_max_pd(denominator,
+                                             _mm256_set1_pd(0x1p-1022))));
+  // Above tan(pi / 8), atan(z) = pi / 4 + atan((z - 1) / (z + 1)).
+  __m256d above = _mm256_cmp_pd(z, _mm256_set1_pd(0.41421356237309503),
+                                _CMP_GT_OQ);
+  z = _mm256_blendv_pd(
+      z, _mm256_div_pd(_mm256_sub_pd(z, one), _mm256_add_pd(z, one)), above);
+  __m256d offset = _mm256_and_pd(above, _mm256_set1_pd(kPi / 4));
+  // atan(z) = 2 atan(w), where w = z / (1 + sqrt(1 + z^2)) and |w| < 0.2.
+  __m256d w = _mm256_div_pd(
+      z, _mm256_add_pd(one, _mm256_sqrt_pd(_mm256_add_pd(
+                                one, _mm256_mul_pd(z, z)))));
+  // The Taylor series of atan(w), to w^23.
+  static constexpr double kSeries[] = {
+      -1.0 / 23, 1.0 / 21, -1.0 / 19, 1.0 / 17, -1.0 / 15, 1.0 / 13,
+      -1.0 / 11, 1.0 / 9,  -1.0 / 7,  1.0 / 5,  -1.0 / 3,  1.0,
+  };
+  __m256d atan_w =
+      _mm256_mul_pd(w, Avx2Polynomial(_mm256_mul_pd(w, w), kSeries));
+  __m256d angle = _mm256_add_pd(
+      offset, _mm256_mul_pd(_mm256_set1_pd(2.0), atan_w));
+  // Unfold to the quadrant of (x, y).
+  angle = _mm256_blendv_pd(
+      angle, _mm256_sub_pd(_mm256_set1_pd(kPi / 2), angle), swap);
+  angle = _mm256_blendv_pd(
+      angle, _mm256_sub_pd(_mm256_set1_pd(kPi), angle),
+      _mm256_cmp_pd(x, zero, _CMP_LT_OQ));
+  return _mm256_xor_pd(angle, _mm256_and_pd(y, sign));
+}
+
+/**
+ * The signed, adapted response of CAM16 to a discounted cone response.
+ */
+__attribute__((target("avx2"))) inline __m256d Avx2ChromaticAdaptation(
+    __m256d discounted) {
+  __m256d sign = _mm256_set1_pd(-0.0);
+  __m256d zero = _mm256_setzero_pd();
+  __m256d scaled = _mm256_div_pd(
+      _mm256_mul_pd(_mm256_set1_pd(Constants::fl),
+                    _mm256_andnot_pd(sign, discounted)),
+      _mm256_set1_pd(100.0));
+  __m256d nonzero = _mm256_cmp_pd(scaled, zero, _CMP_GT_OQ);
+  __m256d af = Avx2Pow(
+      _mm256_max_pd(scaled, _mm256_set1_pd(0x1p-1022)), 0.42);
+  __m256d adapted =
+      _mm256_div_pd(_mm256_mul_pd(_mm256_set1_pd(400.0), af),
+                    _mm256_add_pd(af, _mm256_set1_pd(27.13)));
+  return _mm256_and_pd(nonzero,
+                       _mm256_or_pd(adapted, _mm256_and_pd(discounted, sign)));
+}
+
+/**
+ * x^y where x > 0, and 0 where x is 0.
+ */
+__attribute__((target("avx2"))) inline __m256d Avx2PowOrZero(__m256d x,
+                                                             double y) {
+  __m256d positive = _mm256_cmp_pd(x, _mm256_setzero_pd(), _CMP_GT_OQ);
+  return _mm256_and_pd(
+      positive, Avx2Pow(_mm256_max_pd(x, _mm256_set1_pd(0x1p-1022)), y));
+}
+
+/**
+ * Converts colors four at a time, as many as there are whole groups of,
+ * writing CAM16 coordinates to `cams` if given and HCT coordinates to `hcts`
+ * if given. Returns the number of colors converted.
+ */
+template <bool kCam>
+__attribute__((target("avx2"))) size_t Avx2Convert(const Argb* argbs,
+                                                   size_t count,
+                                                   CamArrays* cams,
+                                                   HctArrays* hcts) {
+  const ChannelResponseTable& table = ChannelResponseTable::Get();
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    // One row of responses per color, summed over its channels, then
+    // transposed to one vector per response.
+    __m256d rows[4];
+    for (int lane = 0; lane < 4; lane++) {
+      Argb argb = argbs[i + lane];
+      rows[lane] = _mm256_add_pd(
+          _mm256_add_pd(
+              _mm256_load_pd(table.responses[0][(argb >> 16) & 0xff]),
+              _mm256_load_pd(table.responses[1][(argb >> 8) & 0xff])),
+          _mm256_load_pd(table.responses[2][argb & 0xff]));
+    }
+    __m256d t0 = _mm256_unpacklo_pd(rows[0], rows[1]);
+    __m256d t1 = _mm256_unpackhi_pd(rows[0], rows[1]);
+    __m256d t2 = _mm256_unpacklo_pd(rows[2], rows[3]);
+    __m256d t3 = _mm256_unpackhi_pd(rows[2], rows[3]);
+    __m256d r_d = _mm256_permute2f128_pd(t0, t2, 0x20);
+    __m256d g_d = _mm256_permute2f128_pd(t1, t3, 0x20);
+    __m256d b_d = _mm256_permute2f128_pd(t0, t2, 0x31);
+    __m256d y = _mm256_permute2f128_pd(t1, t3, 0x31);
+
+    // Chromatic adaptation.
+    __m256d r_a = Avx2ChromaticAdaptation(r_d);
+    __m256d g_a = Avx2ChromaticAdaptation(g_d);
+    __m256d b_a = Avx2ChromaticAdaptation(b_d);
+
+    // Redness-greenness
+    __m256d a = _mm256_div_pd(
+        _mm256_add_pd(
+            _mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(11.0), r_a),
+                          _mm256_mul_pd(_mm256_set1_pd(-12.0), g_a)),
+            b_a),
+        _mm256_set1_pd(11.0));
+    __m256d b = _mm256_div_pd(
+        _mm256_sub_pd(_mm256_add_pd(r_a, g_a),
+                      _mm256_mul_pd(_mm256_set1_pd(2.0), b_a)),
+        _mm256_set1_pd(9.0));
+    __m256d u = _mm256_div_pd(
+        _mm256_add_pd(
+            _mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(20.0), r_a),
+                          _mm256_mul_pd(_mm256_set1_pd(20.0), g_a)),
+            _mm256_mul_pd(_mm256_set1_pd(21.0), b_a)),
+        _mm256_set1_pd(20.0));
+    __m256d p2 = _mm256_div_pd(
+        _mm256_add_pd(
+            _mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(40.0), r_a),
+                          _mm256_mul_pd(_mm256_set1_pd(20.0), g_a)),
+            b_a),
+        _mm256_set1_pd(20.0));
+
+    __m256d degrees = _mm256_div_pd(
+        _mm256_mul_pd(Avx2Atan2(b, a), _mm256_set1_pd(180.0)),
+        _mm256_set1_pd(kPi));
+    __m256d hue = _mm256_add_pd(
+        degrees,
+        _mm256_and_pd(_mm256_cmp_pd(degrees, _mm256_setzero_pd(), _CMP_LT_OQ),
+                      _mm256_set1_pd(360.0)));
+    __m256d ac = _mm256_mul_pd(p2, _mm256_set1_pd(Constants::nbb));
+    __m256d j = _mm256_mul_pd(
+        _mm256_set1_pd(100.0),
+        Avx2PowOrZero(_mm256_div_pd(ac, _mm256_set1_pd(Constants::aw)),
+                      Constants::c * Constants::z));
+    __m256d j_root =
+        _mm256_sqrt_pd(_mm256_div_pd(j, _mm256_set1_pd(100.0)));
+    __m256d hue_prime = _mm256_add_pd(
+        hue, _mm256_and_pd(_mm256_cmp_pd(hue, _mm256_set1_pd(20.14),
+                                         _CMP_LT_OQ),
+                           _mm256_set1_pd(360.0)));
+    __m256d sin_e;
+    __m256d cos_e;
+    Avx2SinCos(_mm256_add_pd(
+                   _mm256_div_pd(_mm256_mul_pd(hue_prime, _mm256_set1_pd(kPi)),
+                                 _mm256_set1_pd(180.0)),
+                   _mm256_set1_pd(2.0)),
+               &sin_e, &cos_e);
+    __m256d e_hue = _mm256_mul_pd(
+        _mm256_set1_pd(0.25), _mm256_add_pd(cos_e, _mm256_set1_pd(3.8)));
+    __m256d p1 = _mm256_mul_pd(
+        _mm256_mul_pd(_mm256_mul_pd(_mm256_set1_pd(50000.0 / 13.0), e_hue),
+                      _mm256_set1_pd(Constants::n_c)),
+        _mm256_set1_pd(Constants::ncb));
+    __m256d t = _mm256_div_pd(
+        _mm256_mul_pd(p1, _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(a, a),
+                                                       _mm256_mul_pd(b, b)))),
+        _mm256_add_pd(u, _mm256_set1_pd(0.305)));
+    __m256d alpha = _mm256_mul_pd(Avx2PowOrZero(t, 0.9),
+                                  _mm256_set1_pd(Constants::n_factor));
+    __m256d c = _mm256_mul_pd(alpha, j_root);
+
+    if (kCam) {
+      __m256d aw_plus_4 = _mm256_set1_pd(Constants::aw + 4.0);
+      __m256d q = _mm256_mul_pd(
+          _mm256_mul_pd(
+              _mm256_mul_pd(_mm256_set1_pd(4.0 / Constants::c), j_root),
+              aw_plus_4),
+          _mm256_set1_pd(Constants::fl_root));
+      __m256d m = _mm256_mul_pd(c, _mm256_set1_pd(Constants::fl_root));
+      __m256d s = _mm256_mul_pd(
+          _mm256_set1_pd(50.0),
+          _mm256_sqrt_pd(_mm256_div_pd(
+              _mm256_mul_pd(alpha, _mm256_set1_pd(Constants::c)), aw_plus_4)));
+      __m256d jstar = _mm256_div_pd(
+          _mm256_mul_pd(_mm256_set1_pd(1.0 + 100.0 * 0.007), j),
+          _mm256_add_pd(_mm256_set1_pd(1.0),
+                        _mm256_mul_pd(_mm256_set1_pd(0.007), j)));
+      __m256d mstar = _mm256_mul_pd(
+          _mm256_set1_pd(1.0 / 0.0228),
+          Avx2Log(_mm256_add_pd(_mm256_set1_pd(1.0),
+                                _mm256_mul_pd(_mm256_set1_pd(0.0228), m))));
+      __m256d sin_h;
+      __m256d cos_h;
+      Avx2SinCos(_mm256_div_pd(_mm256_mul_pd(hue, _mm256_set1_pd(kPi)),
+                               _mm256_set1_pd(180.0)),
+                 &sin_h, &cos_h);
+      _mm256_storeu_pd(&cams->hue[i], hue);
+      _mm256_storeu_pd(&cams->chroma[i], c);
+      _mm256_storeu_pd(&cams->j[i], j);
+      _mm256_storeu_pd(&cams->q[i], q);
+      _mm256_storeu_pd(&cams->m[i], m);
+      _mm256_storeu_pd(&cams->s[i], s);
+      _mm256_storeu_pd(&cams->jstar[i], jstar);
+      _mm256_storeu_pd(&cams->astar[i], _mm256_mul_pd(mstar, cos_h));
+      _mm256_storeu_pd(&cams->bstar[i], _mm256_mul_pd(mstar, sin_h));
+    } else {
+      // LstarFromY.
+      __m256d y_normalized = _mm256_div_pd(y, _mm256_set1_pd(100.0));
+      __m256d linear = _mm256_mul_pd(_mm256_set1_pd(24389.0 / 27.0),
+                                     y_normalized);
+      __m256d cubic = _mm256_sub_pd(
+          _mm256_mul_pd(_mm256_set1_pd(116.0),
+                        Avx2PowOrZero(y_normalized, 1.0 / 3.0)),
+          _mm256_set1_pd(16.0));
+      __m256d tone = _mm256_blendv_pd(
+          cubic, linear,
+          _mm256_cmp_pd(y_normalized, _mm256_set1_pd(216.0 / 24389.0),
+                        _CMP_LE_OQ));
+      _mm256_storeu_pd(&hcts->hue[i], hue);
+      _mm256_storeu_pd(&hcts->chroma[i], c);
+      _mm256_storeu_pd(&hcts->tone[i], tone);
+    }
+  }
+  return i;
+}
+
+}  // namespace
+
+#endif  // MCU_HAS_X86_KERNELS
+
+void CamsFromArgbs(absl::Span<const Argb> argbs, CamArrays* cams) {
+  cams->Resize(argbs.size());
+  size_t converted = 0;
+#ifdef MCU_HAS_X86_KERNELS
+  if (BestSimdLevel() == SimdLevel::kAvx2) {
+    converted = Avx2Convert<true>(argbs.data(), argbs.size(), cams, nullptr);
+  }
+#endif
+  for (size_t i = converted; i < argbs.size(); i++) {
+    Cam cam = CamFromInt(argbs[i]);
+    cams->hue[i] = cam.hue;
+    cams->chroma[i] = cam.chroma;
+    cams->j[i] = cam.j;
+    cams->q[i] = cam.q;
+    cams->m[i] = cam.m;
+    cams->s[i] = cam.s;
+    cams->jstar[i] = cam.jstar;
+    cams->astar[i] = cam.astar;
+    cams->bstar[i] = cam.bstar;
+  }
+}
+
+void HctsFromArgbs(absl::Span<const Argb> argbs, HctArrays* hcts) {
+  hcts->Resize(argbs.size());
+  size_t converted = 0;
+#ifdef MCU_HAS_X86_KERNELS
+  if (BestSimdLevel() == SimdLevel::kAvx2) {
+    converted = Avx2Convert<false>(argbs.data(), argbs.size(), nullptr, hcts);
+  }
+#endif
+  for (size_t i = converted; i < argbs.size(); i++) {
+    Hct hct(argbs[i]);
+    hcts->hue[i] = hct.get_hue();
+    hcts->chroma[i] = hct.get_chroma();
+    hcts->tone[i] = hct.get_tone();
+  }
+}
+
+}  // namespace material_color_utilities
@@ -0,0 +1,99 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CPP_CAM_CAM_BATCH_H_
+#define CPP_CAM_CAM_BATCH_H_
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "absl/types/span.h"
+#include "cpp/cam/cam.h"
+#include "cpp/utils/utils.h"
+
+namespace material_color_utilities {
+
+/**
+ * The CAM16 coordinates of many colors, one array per coordinate, parallel
+ * to each other; the same fields as Cam.
+ *
+ * Functions that fill it resize, rather than reallocate, the arrays, so that
+ * storage reused across calls stops allocating once large enough.
+ */
+struct CamArrays {
+  std::vector<double> hue;
+  std::vector<double> chroma;
+  std::vector<double> j;
+  std::vector<double> q;
+  std::vector<double> m;
+  std::vector<double> s;
+  std::vector<double> jstar;
+  std::vector<double> astar;
+  std::vector<double> bstar;
+
+  size_t size() const { return hue.size(); }
+  void Resize(size_t size);
+
+  /**
+   * Returns the coordinates of the color at `index` as a Cam.
+   */
+  Cam Get(size_t index) const;
+};
+
+/**
+ * The HCT coordinates of many colors, one array per coordinate, parallel to
+ * each other. Reused the same way as CamArrays.
+ */
+struct HctArrays {
+  std::vector<double> hue;
+  std::vector<double> chroma;
+  std::vector<double> tone;
+
+  size_t size() const { return hue.size(); }
+  void Resize(size_t size);
+};
+
+/**
+ * Converts many colors to CAM16 in default viewing conditions; the batch
+ * equivalent of CamFromInt.
+ *
+ * Where the CPU supports AVX2, four colors are converted at a time: the
+ * linearized, adapted cone responses of each channel value are looked up in
+ * a table, and the chromatic adaptation, hue angle and the other
+ * transcendental functions are evaluated with vector polynomials. Each
+ * coordinate is then within 1e-9 of CamFromInt's. Otherwise, and for the
+ * last few colors, the results are CamFromInt's exactly.
+ *
+ * @param argbs Colors to convert.
+ * @param cams Output; resized to the number of colors.
+ */
+void CamsFromArgbs(absl::Span<const Argb> argbs, CamArrays* cams);
+
+/**
+ * Converts many colors to HCT; the batch equivalent of constructing an Hct
+ * from each color. Computes only the CAM16 terms that hue and chroma need,
+ * and is otherwise the same as CamsFromArgbs, with each coordinate within
+ * 1e-9 of Hct's.
+ *
+ * @param argbs Colors to convert.
+ * @param hcts Output; resized to the number of colors.
+ */
+void HctsFromArgbs(absl::Span<const Argb> argbs, HctArrays* hcts);
+
+}  // namespace material_color_utilities
+
+#endif  // CPP_CAM_CAM_BATCH_H_
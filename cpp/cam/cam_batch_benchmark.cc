@@ -0,0 +1,96 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpp/cam/cam_batch.h"
+
+#include <vector>
+
+#include "testing/base/public/benchmark.h"
+#include "cpp/cam/cam.h"
+#include "cpp/cam/hct.h"
+#include "cpp/utils/utils.h"
+
+namespace material_color_utilities {
+
+namespace {
+
+constexpr int kColorCount = 4096;
+
+std::vector<Argb> Colors() {
+  std::vector<Argb> colors;
+  for (int i = 0; i < kColorCount; i++) {
+    colors.push_back(0xff000000 | ((i * 2654435761u) & 0xffffff));
+  }
+  return colors;
+}
+
+void BM_CamFromIntLoop(benchmark::State& state) {
+  std::vector<Argb> colors = Colors();
+  std::vector<Cam> cams(kColorCount);
+  for (auto s : state) {
+    for (int i = 0; i < kColorCount; i++) {
+      cams[i] = CamFromInt(colors[i]);
+    }
+    benchmark::DoNotOptimize(cams.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kColorCount);
+}
+BENCHMARK(BM_CamFromIntLoop);
+
+void BM_CamsFromArgbs(benchmark::State& state) {
+  std::vector<Argb> colors = Colors();
+  CamArrays cams;
+  for (auto s : state) {
+    CamsFromArgbs(colors, &cams);
+    benchmark::DoNotOptimize(cams.hue.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kColorCount);
+}
+BENCHMARK(BM_CamsFromArgbs);
+
+void BM_HctLoop(benchmark::State& state) {
+  std::vector<Argb> colors = Colors();
+  std::vector<double> hues(kColorCount);
+  std::vector<double> chromas(kColorCount);
+  std::vector<double> tones(kColorCount);
+  for (auto s : state) {
+    for (int i = 0; i < kColorCount; i++) {
+      Hct hct(colors[i]);
+      hues[i] = hct.get_hue();
+      chromas[i] = hct.get_chroma();
+      tones[i] = hct.get_tone();
+    }
+    benchmark::DoNotOptimize(hues.data());
+    benchmark::DoNotOptimize(chromas.data());
+    benchmark::DoNotOptimize(tones.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kColorCount);
+}
+BENCHMARK(BM_HctLoop);
+
+void BM_HctsFromArgbs(benchmark::State& state) {
+  std::vector<Argb> colors = Colors();
+  HctArrays hcts;
+  for (auto s : state) {
+    HctsFromArgbs(colors, &hcts);
+    benchmark::DoNotOptimize(hcts.hue.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kColorCount);
+}
+BENCHMARK(BM_HctsFromArgbs);
+
+}  // namespace
+}  // namespace material_color_utilities
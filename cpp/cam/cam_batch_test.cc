@@ -0,0 +1,109 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpp/cam/cam_batch.h"
+
+#include <vector>
+
+#include "testing/base/public/gunit.h"
+#include "cpp/cam/cam.h"
+#include "cpp/cam/hct.h"
+#include "cpp/utils/utils.h"
+
+namespace material_color_utilities {
+
+namespace {
+
+constexpr double kTolerance = 1e-9;
+
+std::vector<Argb> SampleColors() {
+  // Every 997th color, plus black, white and the primaries.
+  std::vector<Argb> argbs = {0xff000000, 0xffffffff, 0xffff0000, 0xff00ff00,
+                             0xff0000ff};
+  for (Argb rgb = 0; rgb <= 0xffffff; rgb += 997) {
+    argbs.push_back(0xff000000 | rgb);
+  }
+  return argbs;
+}
+
+TEST(CamBatchTest, CamsMatchCamFromInt) {
+  std::vector<Argb> argbs = SampleColors();
+  CamArrays cams;
+  CamsFromArgbs(argbs, &cams);
+  ASSERT_EQ(cams.size(), argbs.size());
+  for (size_t i = 0; i < argbs.size(); i++) {
+    Cam expected = CamFromInt(argbs[i]);
+    Cam cam = cams.Get(i);
+    EXPECT_NEAR(cam.hue, expected.hue, kTolerance) << HexFromArgb(argbs[i]);
+    EXPECT_NEAR(cam.chroma, expected.chroma, kTolerance);
+    EXPECT_NEAR(cam.j, expected.j, kTolerance);
+    EXPECT_NEAR(cam.q, expected.q, kTolerance);
+    EXPECT_NEAR(cam.m, expected.m, kTolerance);
+    EXPECT_NEAR(cam.s, expected.s, kTolerance);
+    EXPECT_NEAR(cam.jstar, expected.jstar, kTolerance);
+    EXPECT_NEAR(cam.astar, expected.astar, kTolerance);
+    EXPECT_NEAR(cam.bstar, expected.bstar, kTolerance);
+  }
+}
+
+TEST(CamBatchTest, HctsMatchHct) {
+  std::vector<Argb> argbs = SampleColors();
+  HctArrays hcts;
+  HctsFromArgbs(argbs, &hcts);
+  ASSERT_EQ(hcts.size(), argbs.size());
+  for (size_t i = 0; i < argbs.size(); i++) {
+    Hct expected(argbs[i]);
+    EXPECT_NEAR(hcts.hue[i], expected.get_hue(), kTolerance)
+        << HexFromArgb(argbs[i]);
+    EXPECT_NEAR(hcts.chroma[i], expected.get_chroma(), kTolerance);
+    EXPECT_NEAR(hcts.tone[i], expected.get_tone(), kTolerance);
+  }
+}
+
+TEST(CamBatchTest, BlackHasNoHueOrChroma) {
+  std::vector<Argb> argbs(8, 0xff000000);
+  HctArrays hcts;
+  HctsFromArgbs(argbs, &hcts);
+  for (size_t i = 0; i < argbs.size(); i++) {
+    EXPECT_EQ(hcts.hue[i], 0.0);
+    EXPECT_EQ(hcts.chroma[i], 0.0);
+    EXPECT_EQ(hcts.tone[i], 0.0);
+  }
+}
+
+TEST(CamBatchTest, ArraysAreResizedForEachCall) {
+  std::vector<Argb> argbs = SampleColors();
+  CamArrays cams;
+  HctArrays hcts;
+  CamsFromArgbs(argbs, &cams);
+  HctsFromArgbs(argbs, &hcts);
+  CamsFromArgbs({0xffff0000, 0xff00ff00, 0xff0000ff}, &cams);
+  HctsFromArgbs({0xffff0000, 0xff00ff00, 0xff0000ff}, &hcts);
+  EXPECT_EQ(cams.size(), 3u);
+  EXPECT_EQ(cams.bstar.size(), 3u);
+  EXPECT_EQ(hcts.size(), 3u);
+  EXPECT_EQ(hcts.tone.size(), 3u);
+  EXPECT_NEAR(cams.hue[2], CamFromInt(0xff0000ff).hue, kTolerance);
+  EXPECT_NEAR(hcts.tone[1], Hct(0xff00ff00).get_tone(), kTolerance);
+
+  CamsFromArgbs({}, &cams);
+  HctsFromArgbs({}, &hcts);
+  EXPECT_EQ(cams.size(), 0u);
+  EXPECT_EQ(hcts.size(), 0u);
+}
+
+}  // namespace
+}  // namespace material_color_utilities
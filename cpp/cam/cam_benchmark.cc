@@ -0,0 +1,81 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpp/cam/cam.h"
+
+#include <vector>
+
+#include "testing/base/public/benchmark.h"
+#include "cpp/cam/viewing_conditions.h"
+#include "cpp/utils/utils.h"
+
+namespace material_color_utilities {
+
+namespace {
+
+constexpr int kColorCount = 4096;
+
+std::vector<Argb> Colors() {
+  std::vector<Argb> colors;
+  for (int i = 0; i < kColorCount; i++) {
+    colors.push_back(0xff000000 | ((i * 2654435761u) & 0xffffff));
+  }
+  return colors;
+}
+
+void BM_CamFromInt(benchmark::State& state) {
+  std::vector<Argb> colors = Colors();
+  for (auto s : state) {
+    for (Argb argb : colors) {
+      benchmark::DoNotOptimize(CamFromInt(argb));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kColorCount);
+}
+BENCHMARK(BM_CamFromInt);
+
+// Viewing conditions only known at run time, for comparison with the
+// constants of the default ones.
+void BM_CamFromIntAndViewingConditions(benchmark::State& state) {
+  std::vector<Argb> colors = Colors();
+  ViewingConditions viewing_conditions = DefaultWithBackgroundLstar(30.0);
+  benchmark::DoNotOptimize(&viewing_conditions);
+  for (auto s : state) {
+    for (Argb argb : colors) {
+      benchmark::DoNotOptimize(
+          CamFromIntAndViewingConditions(argb, viewing_conditions));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kColorCount);
+}
+BENCHMARK(BM_CamFromIntAndViewingConditions);
+
+void BM_IntFromCam(benchmark::State& state) {
+  std::vector<Cam> cams;
+  for (Argb argb : Colors()) {
+    cams.push_back(CamFromInt(argb));
+  }
+  for (auto s : state) {
+    for (const Cam& cam : cams) {
+      benchmark::DoNotOptimize(IntFromCam(cam));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kColorCount);
+}
+BENCHMARK(BM_IntFromCam);
+
+}  // namespace
+}  // namespace material_color_utilities
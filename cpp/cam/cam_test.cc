@@ -18,6 +18,7 @@
 
 #include "testing/base/public/gmock.h"
 #include "testing/base/public/gunit.h"
+#include "cpp/cam/viewing_conditions.h"
 
 namespace material_color_utilities {
 
@@ -104,6 +105,44 @@ TEST(CamTest, BlueRoundTrip) {
   Argb argb = IntFromCam(cam);
   EXPECT_THAT(argb, Eq(BLUE));
 }
+
+TEST(CamTest, DefaultViewingConstantsMatchDefaultViewingConditions) {
+  ViewingConstants constants(kDefaultViewingConditions);
+  for (int i = 0; i < 3; i++) {
+    EXPECT_EQ(DefaultViewingConstants::rgb_d[i], constants.rgb_d[i]);
+  }
+  EXPECT_EQ(DefaultViewingConstants::fl, constants.fl);
+  EXPECT_EQ(DefaultViewingConstants::fl_root, constants.fl_root);
+  EXPECT_EQ(DefaultViewingConstants::aw, constants.aw);
+  EXPECT_EQ(DefaultViewingConstants::nbb, constants.nbb);
+  EXPECT_EQ(DefaultViewingConstants::ncb, constants.ncb);
+  EXPECT_EQ(DefaultViewingConstants::c, constants.c);
+  EXPECT_EQ(DefaultViewingConstants::n_c, constants.n_c);
+  EXPECT_EQ(DefaultViewingConstants::z, constants.z);
+  EXPECT_EQ(DefaultViewingConstants::n_factor, constants.n_factor);
+  EXPECT_EQ(DefaultViewingConstants::t_inner_coeff, constants.t_inner_coeff);
+  EXPECT_EQ(DefaultViewingConstants::j_exponent, constants.j_exponent);
+}
+
+TEST(CamTest, DefaultPathMatchesViewingConditionsPath) {
+  for (Argb rgb = 0; rgb <= 0xffffff; rgb += 4093) {
+    Argb argb = 0xff000000 | rgb;
+    Cam cam = CamFromInt(argb);
+    Cam expected =
+        CamFromIntAndViewingConditions(argb, kDefaultViewingConditions);
+    EXPECT_EQ(cam.hue, expected.hue);
+    EXPECT_EQ(cam.chroma, expected.chroma);
+    EXPECT_EQ(cam.j, expected.j);
+    EXPECT_EQ(cam.q, expected.q);
+    EXPECT_EQ(cam.m, expected.m);
+    EXPECT_EQ(cam.s, expected.s);
+    EXPECT_EQ(cam.jstar, expected.jstar);
+    EXPECT_EQ(cam.astar, expected.astar);
+    EXPECT_EQ(cam.bstar, expected.bstar);
+    EXPECT_EQ(IntFromCam(cam),
+              IntFromCamAndViewingConditions(cam, kDefaultViewingConditions));
+  }
+}
 }  // namespace
 
 }  // namespace material_color_utilities
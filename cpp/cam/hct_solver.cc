@@ -18,6 +18,10 @@
 
 #include <math.h>
 
+#include <algorithm>
+#include <vector>
+
+#include "absl/types/span.h"
 #include "cpp/cam/viewing_conditions.h"
 #include "cpp/utils/utils.h"
 
@@ -301,15 +305,35 @@ Vec3 NthVertex(double y, int n) {
   }
 }
 
+/**
+ * Finds the possible vertices of the polygonal intersection of the y plane
+ * and the RGB cube, and their hues.
+ *
+ * @param y The Y value of the plane.
+ * @return The vertices, as returned by NthVertex, with the hue of each that
+ * lies on the cube.
+ */
+GamutPolygon PolygonAt(double y) {
+  GamutPolygon polygon;
+  for (int n = 0; n < 12; n++) {
+    polygon.vertices[n] = NthVertex(y, n);
+    polygon.hues[n] =
+        polygon.vertices[n].a < 0 ? 0.0 : HueOf(polygon.vertices[n]);
+  }
+  return polygon;
+}
+
 /**
  * Finds the segment containing the desired color.
  *
- * @param y The Y value of the color.
+ * @param polygon The polygonal intersection of the plane of the color's Y
+ * value and the RGB cube.
  * @param target_hue The hue of the color.
  * @return A list of two sets of linear RGB coordinates, each corresponding to
  * an endpoint of the segment containing the desired color.
  */
-void BisectToSegment(double y, double target_hue, Vec3 out[2]) {
+void BisectToSegment(const GamutPolygon& polygon, double target_hue,
+                     Vec3 out[2]) {
   Vec3 left = (Vec3){-1.0, -1.0, -1.0};
   Vec3 right = left;
   double left_hue = 0.0;
@@ -317,11 +341,11 @@ void BisectToSegment(double y, double target_hue, Vec3 out[2]) {
   bool initialized = false;
   bool uncut = true;
   for (int n = 0; n < 12; n++) {
-    Vec3 mid = NthVertex(y, n);
+    Vec3 mid = polygon.vertices[n];
     if (mid.a < 0) {
       continue;
     }
-    double mid_hue = HueOf(mid);
+    double mid_hue = polygon.hues[n];
     if (!initialized) {
       left = mid;
       right = mid;
@@ -360,13 +384,14 @@ int CriticalPlaneAbove(double x) { return (int)ceil(x - 0.5); }
 /**
  * Finds a color with the given Y and hue on the boundary of the cube.
  *
- * @param y The Y value of the color.
+ * @param polygon The polygonal intersection of the plane of the color's Y
+ * value and the RGB cube.
  * @param target_hue The hue of the color.
  * @return The desired color, in linear RGB coordinates.
  */
-Vec3 BisectToLimit(double y, double target_hue) {
+Vec3 BisectToLimit(const GamutPolygon& polygon, double target_hue) {
   Vec3 segment[2];
-  BisectToSegment(y, target_hue, segment);
+  BisectToSegment(polygon, target_hue, segment);
   Vec3 left = segment[0];
   double left_hue = HueOf(left);
   Vec3 right = segment[1];
@@ -404,86 +429,134 @@ Vec3 BisectToLimit(double y, double target_hue) {
   return Midpoint(left, right);
 }
 
+Vec3 BisectToLimit(double y, double target_hue) {
+  return BisectToLimit(PolygonAt(y), target_hue);
+}
+
 double InverseChromaticAdaptation(double adapted) {
   double adapted_abs = abs(adapted);
   double base = fmax(0, 27.13 * adapted_abs / (400.0 - adapted_abs));
   return Signum(adapted) * pow(base, 1.0 / 0.42);
 }
 
+/**
+ * Terms of the CAM16 inverse that depend only on the hue, which a batch of
+ * requests at the same hue computes once.
+ */
+struct HueTerms {
+  double p1;
+  double h_sin;
+  double h_cos;
+};
+
+HueTerms HueTermsOf(double hue_radians) {
+  using Constants = DefaultViewingConstants;
+  double e_hue = 0.25 * (cos(hue_radians + 2.0) + 3.8);
+  return HueTerms{
+      e_hue * (50000.0 / 13.0) * Constants::n_c * Constants::ncb,
+      sin(hue_radians),
+      cos(hue_radians),
+  };
+}
+
+/**
+ * Returns the linear RGB coordinates of the color with the given hue,
+ * chroma, and J in CAM16; one round of FindResultByJ.
+ */
+Vec3 LinrgbAtJ(const HueTerms& hue, double chroma, double j) {
+  // ===========================================================
+  // Operations inlined from Cam16 to avoid repeated calculation
+  // ===========================================================
+  using Constants = DefaultViewingConstants;
+  double j_normalized = j / 100.0;
+  double alpha = chroma == 0.0 || j == 0.0 ? 0.0 : chroma / sqrt(j_normalized);
+  double t = pow(alpha * Constants::t_inner_coeff, 1.0 / 0.9);
+  double ac = Constants::aw * pow(j_normalized, Constants::j_exponent);
+  double p2 = ac / Constants::nbb;
+  double gamma = 23.0 * (p2 + 0.305) * t /
+                 (23.0 * hue.p1 + 11 * t * hue.h_cos + 108.0 * t * hue.h_sin);
+  double a = gamma * hue.h_cos;
+  double b = gamma * hue.h_sin;
+  double r_a = (460.0 * p2 + 451.0 * a + 288.0 * b) / 1403.0;
+  double g_a = (460.0 * p2 - 891.0 * a - 261.0 * b) / 1403.0;
+  double b_a = (460.0 * p2 - 220.0 * a - 6300.0 * b) / 1403.0;
+  double r_c_scaled = InverseChromaticAdaptation(r_a);
+  double g_c_scaled = InverseChromaticAdaptation(g_a);
+  double b_c_scaled = InverseChromaticAdaptation(b_a);
+  Vec3 scaled = (Vec3){r_c_scaled, g_c_scaled, b_c_scaled};
+  return MatrixMultiply(scaled, kLinrgbFromScaledDiscount);
+}
+
+/**
+ * One round of Newton's method in FindResultByJ.
+ *
+ * @param linrgb The color at the current estimate of J.
+ * @param y The desired Y.
+ * @param last Whether this is the final round.
+ * @param j The current estimate of J, updated for the next round.
+ * @param result Set to the answer if the round finishes the search, either
+ * the color found or 0 if none was.
+ * @return Whether the round finishes the search.
+ */
+bool NewtonRound(Vec3 linrgb, double y, bool last, double* j, Argb* result) {
+  // ===========================================================
+  // Operations inlined from Cam16 to avoid repeated calculation
+  // ===========================================================
+  if (linrgb.a < 0 || linrgb.b < 0 || linrgb.c < 0) {
+    *result = 0;
+    return true;
+  }
+  double k_r = kYFromLinrgb[0];
+  double k_g = kYFromLinrgb[1];
+  double k_b = kYFromLinrgb[2];
+  double fnj = k_r * linrgb.a + k_g * linrgb.b + k_b * linrgb.c;
+  if (fnj <= 0) {
+    *result = 0;
+    return true;
+  }
+  if (last || abs(fnj - y) < 0.002) {
+    if (linrgb.a > 100.01 || linrgb.b > 100.01 || linrgb.c > 100.01) {
+      *result = 0;
+    } else {
+      *result = ArgbFromLinrgb(linrgb);
+    }
+    return true;
+  }
+  // Iterates with Newton method,
+  // Using 2 * fn(j) / j as the approximation of fn'(j)
+  *j = *j - (fnj - y) * *j / (2 * fnj);
+  return false;
+}
+
+constexpr int kNewtonRounds = 5;
+
 /**
  * Finds a color with the given hue, chroma, and Y.
  *
- * @param hue_radians The desired hue in radians.
+ * @param hue The terms of the desired hue.
  * @param chroma The desired chroma.
  * @param y The desired Y.
  * @return The desired color as a hexadecimal integer, if found; 0 otherwise.
  */
-Argb FindResultByJ(double hue_radians, double chroma, double y) {
+Argb FindResultByJ(const HueTerms& hue, double chroma, double y) {
   // Initial estimate of j.
   double j = sqrt(y) * 11.0;
-  // ===========================================================
-  // Operations inlined from Cam16 to avoid repeated calculation
-  // ===========================================================
-  ViewingConditions viewing_conditions = kDefaultViewingConditions;
-  double t_inner_coeff =
-      1 /
-      pow(1.64 - pow(0.29, viewing_conditions.background_y_to_white_point_y),
-          0.73);
-  double e_hue = 0.25 * (cos(hue_radians + 2.0) + 3.8);
-  double p1 = e_hue * (50000.0 / 13.0) * viewing_conditions.n_c *
-              viewing_conditions.ncb;
-  double h_sin = sin(hue_radians);
-  double h_cos = cos(hue_radians);
-  for (int iteration_round = 0; iteration_round < 5; iteration_round++) {
-    // ===========================================================
-    // Operations inlined from Cam16 to avoid repeated calculation
-    // ===========================================================
-    double j_normalized = j / 100.0;
-    double alpha =
-        chroma == 0.0 || j == 0.0 ? 0.0 : chroma / sqrt(j_normalized);
-    double t = pow(alpha * t_inner_coeff, 1.0 / 0.9);
-    double ac =
-        viewing_conditions.aw *
-        pow(j_normalized, 1.0 / viewing_conditions.c / viewing_conditions.z);
-    double p2 = ac / viewing_conditions.nbb;
-    double gamma = 23.0 * (p2 + 0.305) * t /
-                   (23.0 * p1 + 11 * t * h_cos + 108.0 * t * h_sin);
-    double a = gamma * h_cos;
-    double b = gamma * h_sin;
-    double r_a = (460.0 * p2 + 451.0 * a + 288.0 * b) / 1403.0;
-    double g_a = (460.0 * p2 - 891.0 * a - 261.0 * b) / 1403.0;
-    double b_a = (460.0 * p2 - 220.0 * a - 6300.0 * b) / 1403.0;
-    double r_c_scaled = InverseChromaticAdaptation(r_a);
-    double g_c_scaled = InverseChromaticAdaptation(g_a);
-    double b_c_scaled = InverseChromaticAdaptation(b_a);
-    Vec3 scaled = (Vec3){r_c_scaled, g_c_scaled, b_c_scaled};
-    Vec3 linrgb = MatrixMultiply(scaled, kLinrgbFromScaledDiscount);
-    // ===========================================================
-    // Operations inlined from Cam16 to avoid repeated calculation
-    // ===========================================================
-    if (linrgb.a < 0 || linrgb.b < 0 || linrgb.c < 0) {
-      return 0;
+  Argb result = 0;
+  for (int iteration_round = 0; iteration_round < kNewtonRounds;
+       iteration_round++) {
+    Vec3 linrgb = LinrgbAtJ(hue, chroma, j);
+    if (NewtonRound(linrgb, y, iteration_round == kNewtonRounds - 1, &j,
+                    &result)) {
+      return result;
     }
-    double k_r = kYFromLinrgb[0];
-    double k_g = kYFromLinrgb[1];
-    double k_b = kYFromLinrgb[2];
-    double fnj = k_r * linrgb.a + k_g * linrgb.b + k_b * linrgb.c;
-    if (fnj <= 0) {
-      return 0;
-    }
-    if (iteration_round == 4 || abs(fnj - y) < 0.002) {
-      if (linrgb.a > 100.01 || linrgb.b > 100.01 || linrgb.c > 100.01) {
-        return 0;
-      }
-      return ArgbFromLinrgb(linrgb);
-    }
-    // Iterates with Newton method,
-    // Using 2 * fn(j) / j as the approximation of fn'(j)
-    j = j - (fnj - y) * j / (2 * fnj);
   }
   return 0;
 }
 
+Argb FindResultByJ(double hue_radians, double chroma, double y) {
+  return FindResultByJ(HueTermsOf(hue_radians), chroma, y);
+}
+
 /**
  * Finds an sRGB color with the given hue, chroma, and L*, if possible.
  *
@@ -523,4 +596,160 @@ Argb SolveToInt(double hue_degrees, double chroma, double lstar) {
 Cam SolveToCam(double hue_degrees, double chroma, double lstar) {
   return CamFromInt(SolveToInt(hue_degrees, chroma, lstar));
 }
+
+/**
+ * Solves `count` requests, of which `request_at(i)` returns the ith, into
+ * `results`. Requests are solved in groups of kLanes whose Newton rounds run
+ * in lock-step, so that the independent arithmetic of different requests
+ * overlaps; consecutive requests at the same hue share its terms.
+ */
+template <typename RequestAt>
+void SolveBatch(size_t count, RequestAt request_at, absl::Span<Argb> results) {
+  constexpr int kLanes = 8;
+  size_t indices[kLanes];
+  HueTerms hues[kLanes];
+  double hue_radians[kLanes];
+  double chromas[kLanes];
+  double ys[kLanes];
+  double js[kLanes];
+  bool active[kLanes];
+  Vec3 linrgbs[kLanes];
+  int lane_count = 0;
+
+  auto solve_lanes = [&]() {
+    for (int lane = 0; lane < lane_count; lane++) {
+      js[lane] = sqrt(ys[lane]) * 11.0;
+      active[lane] = true;
+    }
+    for (int round = 0; round < kNewtonRounds; round++) {
+      for (int lane = 0; lane < lane_count; lane++) {
+        if (active[lane]) {
+          linrgbs[lane] = LinrgbAtJ(hues[lane], chromas[lane], js[lane]);
+        }
+      }
+      for (int lane = 0; lane < lane_count; lane++) {
+        if (active[lane] &&
+            NewtonRound(linrgbs[lane], ys[lane], round == kNewtonRounds - 1,
+                        &js[lane], &results[indices[lane]])) {
+          active[lane] = false;
+        }
+      }
+    }
+    for (int lane = 0; lane < lane_count; lane++) {
+      if (results[indices[lane]] == 0) {
+        results[indices[lane]] =
+            ArgbFromLinrgb(BisectToLimit(ys[lane], hue_radians[lane]));
+      }
+    }
+    lane_count = 0;
+  };
+
+  double last_hue_degrees = NAN;
+  double last_hue_radians = 0.0;
+  HueTerms last_hue_terms = {};
+  for (size_t i = 0; i < count; i++) {
+    HctRequest request = request_at(i);
+    if (request.chroma < 0.0001 || request.tone < 0.0001 ||
+        request.tone > 99.9999) {
+      results[i] = IntFromLstar(request.tone);
+      continue;
+    }
+    double hue_degrees = SanitizeDegreesDouble(request.hue);
+    if (hue_degrees != last_hue_degrees) {
+      last_hue_degrees = hue_degrees;
+      last_hue_radians = hue_degrees / 180 * kPi;
+      last_hue_terms = HueTermsOf(last_hue_radians);
+    }
+    indices[lane_count] = i;
+    hues[lane_count] = last_hue_terms;
+    hue_radians[lane_count] = last_hue_radians;
+    chromas[lane_count] = request.chroma;
+    ys[lane_count] = YFromLstar(request.tone);
+    if (++lane_count == kLanes) {
+      solve_lanes();
+    }
+  }
+  solve_lanes();
+}
+
+void SolveToIntBatch(absl::Span<const HctRequest> requests,
+                     absl::Span<Argb> results) {
+  SolveBatch(
+      requests.size(), [&](size_t i) { return requests[i]; }, results);
+}
+
+void SolveToIntBatch(double hue_degrees, double chroma,
+                     absl::Span<const double> tones,
+                     absl::Span<Argb> results) {
+  SolveBatch(
+      tones.size(),
+      [&](size_t i) { return HctRequest{hue_degrees, chroma, tones[i]}; },
+      results);
+}
+
+constexpr int kHues = 360;
+constexpr int kTones = 101;
+
+GamutTable::GamutTable()
+    : polygons_(kTones),
+      limits_(kHues * kTones),
+      chroma_bounds_(kHues * kTones) {
+  for (int tone = 0; tone < kTones; tone++) {
+    polygons_[tone] =
+        PolygonAt(YFromLstar(std::clamp<double>(tone, 0.0001, 99.9999)));
+  }
+  std::vector<double> chromas(kHues * kTones);
+  for (int hue = 0; hue < kHues; hue++) {
+    // The same arithmetic as SolveToInt, so that requests at a whole hue and
+    // tone can be answered from the table.
+    double hue_radians = static_cast<double>(hue) / 180 * kPi;
+    for (int tone = 0; tone < kTones; tone++) {
+      Argb limit = ArgbFromLinrgb(BisectToLimit(polygons_[tone], hue_radians));
+      limits_[hue * kTones + tone] = limit;
+      chromas[hue * kTones + tone] = CamFromInt(limit).chroma;
+    }
+  }
+  // Newton's method in FindResultByJ may land slightly outside the gamut, and
+  // the limit between grid points may bulge past the corners; over a dense
+  // grid neither exceeds the largest corner by more than 1% and 0.6 chroma.
+  // The bounds leave a wide margin for both.
+  for (int hue = 0; hue < kHues; hue++) {
+    int next_hue = (hue + 1) % kHues;
+    for (int tone = 0; tone + 1 < kTones; tone++) {
+      double corner = std::max({chromas[hue * kTones + tone],
+                                chromas[hue * kTones + tone + 1],
+                                chromas[next_hue * kTones + tone],
+                                chromas[next_hue * kTones + tone + 1]});
+      chroma_bounds_[hue * kTones + tone] = corner * 1.05 + 2.0;
+    }
+  }
+}
+
+const GamutTable& GamutTable::Default() {
+  static const GamutTable* table = new GamutTable();
+  return *table;
+}
+
+Argb GamutTable::SolveToInt(double hue_degrees, double chroma,
+                            double lstar) const {
+  if (chroma < 0.0001 || lstar < 0.0001 || lstar > 99.9999) {
+    return IntFromLstar(lstar);
+  }
+  hue_degrees = SanitizeDegreesDouble(hue_degrees);
+  int hue = std::min(static_cast<int>(hue_degrees), kHues - 1);
+  int tone = static_cast<int>(lstar);
+  int index = hue * kTones + tone;
+  if (chroma <= chroma_bounds_[index]) {
+    return material_color_utilities::SolveToInt(hue_degrees, chroma, lstar);
+  }
+  if (lstar != tone) {
+    double hue_radians = hue_degrees / 180 * kPi;
+    return ArgbFromLinrgb(BisectToLimit(YFromLstar(lstar), hue_radians));
+  }
+  if (hue_degrees == hue) {
+    return limits_[index];
+  }
+  double hue_radians = hue_degrees / 180 * kPi;
+  return ArgbFromLinrgb(BisectToLimit(polygons_[tone], hue_radians));
+}
 }  // namespace material_color_utilities
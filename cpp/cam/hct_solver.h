@@ -17,6 +17,9 @@
 #ifndef CPP_CAM_HCT_SOLVER_H_
 #define CPP_CAM_HCT_SOLVER_H_
 
+#include <vector>
+
+#include "absl/types/span.h"
 #include "cpp/cam/cam.h"
 
 namespace material_color_utilities {
@@ -24,5 +27,80 @@ namespace material_color_utilities {
 Argb SolveToInt(double hue_degrees, double chroma, double lstar);
 Cam SolveToCam(double hue_degrees, double chroma, double lstar);
 
+/**
+ * A color to solve for: a hue in degrees, a chroma, and a tone, or L*.
+ */
+struct HctRequest {
+  double hue = 0.0;
+  double chroma = 0.0;
+  double tone = 0.0;
+};
+
+/**
+ * Solves many colors at once, writing to `results`, which must be as long as
+ * `requests`, exactly what SolveToInt returns for each.
+ *
+ * Several requests are solved in lock-step, so that their independent
+ * arithmetic overlaps, and consecutive requests at the same hue share the
+ * terms that depend only on it; e.g. a gradient in tone is faster to solve
+ * than one in hue.
+ */
+void SolveToIntBatch(absl::Span<const HctRequest> requests,
+                     absl::Span<Argb> results);
+
+/**
+ * Variant of SolveToIntBatch for many tones of one hue and chroma, as in a
+ * tonal palette. `results` must be as long as `tones`.
+ */
+void SolveToIntBatch(double hue_degrees, double chroma,
+                     absl::Span<const double> tones, absl::Span<Argb> results);
+
+/**
+ * The possible vertices of the polygon in which a plane of constant Y cuts
+ * the linear RGB cube, and their CAM16 hues in radians. Vertices that do not
+ * lie on the cube are (-1, -1, -1).
+ */
+struct GamutPolygon {
+  Vec3 vertices[12];
+  double hues[12];
+};
+
+/**
+ * Precomputed limits of the sRGB gamut in HCT, which let SolveToInt answer
+ * requests for more chroma than a hue and tone allow without first trying,
+ * and failing, to solve for the exact color.
+ *
+ * For each whole-degree hue and whole tone, the table holds the color
+ * SolveToInt returns when the requested chroma is out of gamut, and for each
+ * cell between them, a chroma above which no request in the cell is in
+ * gamut. For each whole tone, it holds the boundary of the gamut, which
+ * halves the search for the color of largest chroma at any other hue.
+ * Building it takes about 87 ms and 300 KB, so it pays off for callers that
+ * solve many colors, e.g. to generate tonal palettes.
+ */
+class GamutTable {
+ public:
+  GamutTable();
+
+  /**
+   * Returns a table shared by the whole process, built on first use.
+   */
+  static const GamutTable& Default();
+
+  /**
+   * Returns exactly what SolveToInt(hue_degrees, chroma, lstar) returns.
+   */
+  Argb SolveToInt(double hue_degrees, double chroma, double lstar) const;
+
+ private:
+  // Indexed by tone, from 0 to 100.
+  std::vector<GamutPolygon> polygons_;
+  // Indexed by hue * 101 + tone, for hues 0 to 359 and tones 0 to 100.
+  std::vector<Argb> limits_;
+  // Indexed likewise, for the cell between hue and hue + 1, tone and
+  // tone + 1.
+  std::vector<float> chroma_bounds_;
+};
+
 }  // namespace material_color_utilities
 #endif  // CPP_CAM_HCT_SOLVER_H_
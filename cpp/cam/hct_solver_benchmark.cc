@@ -0,0 +1,113 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpp/cam/hct_solver.h"
+
+#include <vector>
+
+#include "testing/base/public/benchmark.h"
+#include "absl/types/span.h"
+#include "cpp/utils/utils.h"
+
+namespace material_color_utilities {
+
+namespace {
+
+// Arguments: whether to use GamutTable::Default(), and the chroma requested.
+// Solves the whole tones of tonal palettes at hues that are not whole
+// degrees, as TonalPalette::get does; high chromas are out of gamut at most
+// tones.
+void BM_SolveToInt(benchmark::State& state) {
+  bool use_table = state.range(0);
+  double chroma = state.range(1);
+  const GamutTable& table = GamutTable::Default();
+  for (auto s : state) {
+    for (double hue = 0.37; hue < 360.0; hue += 15.0) {
+      for (int tone = 0; tone <= 100; tone++) {
+        benchmark::DoNotOptimize(use_table
+                                     ? table.SolveToInt(hue, chroma, tone)
+                                     : SolveToInt(hue, chroma, tone));
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * 24 * 101);
+  state.SetLabel(use_table ? "table" : "solver");
+}
+BENCHMARK(BM_SolveToInt)->ArgsProduct({{0, 1}, {16, 48, 200}});
+
+// Argument: the chroma requested. Solves the whole tones of tonal palettes
+// one at a time, as TonalPalette::get does, for comparison with
+// BM_SolveToIntBatch.
+void BM_SolveToIntLoop(benchmark::State& state) {
+  double chroma = state.range(0);
+  std::vector<Argb> results(101);
+  for (auto s : state) {
+    for (double hue = 0.37; hue < 360.0; hue += 15.0) {
+      for (int tone = 0; tone <= 100; tone++) {
+        results[tone] = SolveToInt(hue, chroma, tone);
+      }
+      benchmark::DoNotOptimize(results.data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * 24 * 101);
+}
+BENCHMARK(BM_SolveToIntLoop)->Arg(16)->Arg(48)->Arg(200);
+
+// Argument: the chroma requested. The same palettes as BM_SolveToIntLoop,
+// solved with the fixed-hue variant of SolveToIntBatch.
+void BM_SolveToIntBatch(benchmark::State& state) {
+  double chroma = state.range(0);
+  std::vector<double> tones;
+  for (int tone = 0; tone <= 100; tone++) {
+    tones.push_back(tone);
+  }
+  std::vector<Argb> results(101);
+  for (auto s : state) {
+    for (double hue = 0.37; hue < 360.0; hue += 15.0) {
+      SolveToIntBatch(hue, chroma, tones, absl::MakeSpan(results));
+      benchmark::DoNotOptimize(results.data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * 24 * 101);
+}
+BENCHMARK(BM_SolveToIntBatch)->Arg(16)->Arg(48)->Arg(200);
+
+// A gradient around the hue circle at constant chroma and tone, where every
+// request has its own hue.
+void BM_SolveToIntBatchHueGradient(benchmark::State& state) {
+  std::vector<HctRequest> requests;
+  for (int i = 0; i < 2424; i++) {
+    requests.push_back({i * 360.0 / 2424, 36.0, 60.0});
+  }
+  std::vector<Argb> results(requests.size());
+  for (auto s : state) {
+    SolveToIntBatch(requests, absl::MakeSpan(results));
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * requests.size());
+}
+BENCHMARK(BM_SolveToIntBatchHueGradient);
+
+void BM_BuildGamutTable(benchmark::State& state) {
+  for (auto s : state) {
+    GamutTable table;
+    benchmark::DoNotOptimize(&table);
+  }
+}
+BENCHMARK(BM_BuildGamutTable)->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace material_color_utilities
@@ -16,8 +16,11 @@
 
 #include "cpp/cam/hct_solver.h"
 
+#include <vector>
+
 #include "testing/base/public/gmock.h"
 #include "testing/base/public/gunit.h"
+#include "absl/types/span.h"
 #include "cpp/cam/cam.h"
 #include "cpp/utils/utils.h"
 
@@ -70,5 +73,75 @@ TEST(HctSolverTest, Exhaustive) {
     EXPECT_THAT(recovered, Eq(color));
   }
 }
+
+TEST(HctSolverTest, GamutTableMatchesSolveToIntOnDenseGrid) {
+  const GamutTable& table = GamutTable::Default();
+  // Includes every whole hue and tone, where the table answers from its
+  // grid, and chromas on either side of the gamut's limit, where it decides
+  // whether to solve exactly.
+  for (double hue = 0.0; hue < 360.0; hue += 0.5) {
+    for (double tone = 0.0; tone <= 100.0; tone += 0.5) {
+      double limit = CamFromInt(SolveToInt(hue, 200.0, tone)).chroma;
+      for (double chroma : {0.0, 10.0, 40.0, limit - 0.5, limit + 0.25,
+                            limit + 1.0, limit + 5.0, 200.0}) {
+        ASSERT_EQ(table.SolveToInt(hue, chroma, tone),
+                  SolveToInt(hue, chroma, tone))
+            << hue << " " << chroma << " " << tone;
+      }
+    }
+  }
+}
+
+TEST(HctSolverTest, GamutTableSanitizesHue) {
+  const GamutTable& table = GamutTable::Default();
+  for (double hue : {-720.0, -30.25, -1e-20, 360.0, 421.0}) {
+    EXPECT_EQ(table.SolveToInt(hue, 120.0, 50.0), SolveToInt(hue, 120.0, 50.0))
+        << hue;
+    EXPECT_EQ(table.SolveToInt(hue, 20.0, 50.5), SolveToInt(hue, 20.0, 50.5))
+        << hue;
+  }
+}
+
+TEST(HctSolverTest, BatchMatchesSolveToInt) {
+  // Runs of one hue mixed with hues that change every request, with chromas
+  // in and out of gamut and the tones SolveToInt answers without solving.
+  std::vector<HctRequest> requests;
+  for (int i = 0; i < 20000; i++) {
+    double hue = i % 3 == 0 ? (i * 0.37) - 100.0 : (i / 50) * 7.3;
+    double chroma = (i * 13 % 160) * 0.9;
+    double tone = (i * 7 % 1003) * 0.1;
+    requests.push_back({hue, chroma, tone});
+  }
+  std::vector<Argb> results(requests.size());
+  SolveToIntBatch(requests, absl::MakeSpan(results));
+  for (size_t i = 0; i < requests.size(); i++) {
+    ASSERT_EQ(results[i], SolveToInt(requests[i].hue, requests[i].chroma,
+                                     requests[i].tone))
+        << requests[i].hue << " " << requests[i].chroma << " "
+        << requests[i].tone;
+  }
+}
+
+TEST(HctSolverTest, FixedHueBatchMatchesSolveToInt) {
+  std::vector<double> tones;
+  for (int tone = 0; tone <= 1000; tone++) {
+    tones.push_back(tone * 0.1);
+  }
+  std::vector<Argb> results(tones.size());
+  for (double hue : {0.0, 27.5, 101.0, 282.25, 359.9}) {
+    for (double chroma : {0.0, 4.0, 16.0, 48.0, 120.0}) {
+      SolveToIntBatch(hue, chroma, tones, absl::MakeSpan(results));
+      for (size_t i = 0; i < tones.size(); i++) {
+        ASSERT_EQ(results[i], SolveToInt(hue, chroma, tones[i]))
+            << hue << " " << chroma << " " << tones[i];
+      }
+    }
+  }
+}
+
+TEST(HctSolverTest, EmptyBatch) {
+  SolveToIntBatch({}, {});
+  SolveToIntBatch(0.0, 0.0, {}, {});
+}
 }  // namespace
 }  // namespace material_color_utilities
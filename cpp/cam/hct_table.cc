@@ -0,0 +1,159 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpp/cam/hct_table.h"
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cpp/cam/cam.h"
+#include "cpp/utils/parallel.h"
+#include "cpp/utils/utils.h"
+
+namespace material_color_utilities {
+
+namespace {
+
+constexpr size_t kColorCount = size_t{1} << 24;
+
+/**
+ * The start of a table file, followed by three uint16_t per color: hue,
+ * chroma and tone, in the order of the colors' RGB values.
+ * `magic`: identifies the format and its version.
+ * `byte_order`: kByteOrder as written, which reads differently on a machine
+ *               of the other byte order.
+ * `color_count`: kColorCount.
+ */
+struct FileHeader {
+  char magic[8];
+  uint32_t byte_order;
+  uint32_t color_count;
+};
+
+constexpr char kMagic[8] = {'M', 'C', 'U', 'H', 'C', 'T', '0', '1'};
+constexpr uint32_t kByteOrder = 0x01020304;
+constexpr size_t kFileSize =
+    sizeof(FileHeader) + kColorCount * 3 * sizeof(uint16_t);
+
+uint16_t Quantize(double value, double step) {
+  return static_cast<uint16_t>(
+      std::clamp<long>(std::lround(value / step), 0, 65535));
+}
+
+}  // namespace
+
+HctTable::HctTable(const void* mapping, size_t size)
+    : mapping_(mapping),
+      size_(size),
+      entries_(reinterpret_cast<const uint16_t*>(
+          static_cast<const char*>(mapping) + sizeof(FileHeader))) {}
+
+HctTable::~HctTable() { munmap(const_cast<void*>(mapping_), size_); }
+
+std::unique_ptr<HctTable> HctTable::Open(const std::string& path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return nullptr;
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 ||
+      static_cast<size_t>(file_stat.st_size) != kFileSize) {
+    close(fd);
+    return nullptr;
+  }
+  void* mapping = mmap(nullptr, kFileSize, PROT_READ, MAP_SHARED, fd, 0);
+  // The mapping keeps the file open.
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    return nullptr;
+  }
+  FileHeader header;
+  memcpy(&header, mapping, sizeof(header));
+  if (memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+      header.byte_order != kByteOrder || header.color_count != kColorCount) {
+    munmap(mapping, kFileSize);
+    return nullptr;
+  }
+  return std::unique_ptr<HctTable>(new HctTable(mapping, kFileSize));
+}
+
+bool HctTable::Write(const std::string& path, int num_threads) {
+  std::vector<uint16_t> entries(kColorCount * 3);
+  // One task per red value.
+  ParallelFor(num_threads, 256, [&](int red) {
+    for (uint32_t rgb = red << 16; rgb < static_cast<uint32_t>(red + 1) << 16;
+         rgb++) {
+      HctCoordinates coordinates = HctCoordinatesFromArgb(rgb, nullptr);
+      uint16_t* entry = &entries[3 * rgb];
+      // Hues round to the nearest step around the circle.
+      entry[0] = static_cast<uint16_t>(
+          std::lround(coordinates.hue / kHueStep) & 0xffff);
+      entry[1] = Quantize(coordinates.chroma, kChromaStep);
+      entry[2] = Quantize(coordinates.tone, kToneStep);
+    }
+  });
+
+  FileHeader header;
+  memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.byte_order = kByteOrder;
+  header.color_count = kColorCount;
+  // Writes to a new file in the same directory, then renames it over `path`,
+  // so that processes which have mapped the old file keep reading it intact
+  // instead of seeing it truncated.
+  std::string temp_path = path + ".XXXXXX";
+  int fd = mkstemp(temp_path.data());
+  if (fd < 0) {
+    return false;
+  }
+  // mkstemp creates the file readable only by its owner; tables are shared.
+  FILE* file = fchmod(fd, 0644) == 0 ? fdopen(fd, "wb") : nullptr;
+  if (file == nullptr) {
+    close(fd);
+    remove(temp_path.c_str());
+    return false;
+  }
+  bool written =
+      fwrite(&header, sizeof(header), 1, file) == 1 &&
+      fwrite(entries.data(), sizeof(uint16_t), entries.size(), file) ==
+          entries.size();
+  written = fclose(file) == 0 && written;
+  if (!written || rename(temp_path.c_str(), path.c_str()) != 0) {
+    remove(temp_path.c_str());
+    return false;
+  }
+  return true;
+}
+
+HctCoordinates HctCoordinatesFromArgb(Argb argb, const HctTable* table) {
+  if (table != nullptr) {
+    return table->Get(argb);
+  }
+  Cam cam = CamFromInt(argb);
+  return HctCoordinates{cam.hue, cam.chroma, LstarFromArgb(argb)};
+}
+
+}  // namespace material_color_utilities
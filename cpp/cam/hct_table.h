@@ -0,0 +1,109 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CPP_CAM_HCT_TABLE_H_
+#define CPP_CAM_HCT_TABLE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+
+#include "cpp/utils/utils.h"
+
+namespace material_color_utilities {
+
+/**
+ * The hue, in degrees, chroma and tone of a color in HCT.
+ */
+struct HctCoordinates {
+  double hue = 0.0;
+  double chroma = 0.0;
+  double tone = 0.0;
+};
+
+/**
+ * A precomputed table of the HCT coordinates of all 2^24 sRGB colors, read
+ * from a file that is mapped read-only, so that processes using the same file
+ * share one copy in memory. Alpha is ignored, as it is by Hct.
+ *
+ * Each coordinate is stored as a 16-bit fixed-point number, 96 MiB in all,
+ * and is within half a step of the exact value:
+ * hue: steps of 360 / 65536 degrees; within 0.0028 degrees, measured around
+ *      the hue circle.
+ * chroma: steps of 1 / 512; within 0.001.
+ * tone: steps of 1 / 655.35; within 0.0008.
+ *
+ * Files are written by HctTable::Write, or the hct_table_generator tool, in
+ * the byte order of the machine that writes them, and are rejected by
+ * machines of the other byte order.
+ */
+class HctTable {
+ public:
+  /**
+   * Maps the table in the file at `path`.
+   *
+   * @return The table, or null if the file cannot be read or does not hold a
+   * table in this format.
+   */
+  static std::unique_ptr<HctTable> Open(const std::string& path);
+
+  /**
+   * Computes a table and writes it to the file at `path`, replacing any file
+   * there. The table is written to a new file in the same directory, which
+   * is then renamed to `path`, so tables already opened from the old file
+   * stay valid.
+   *
+   * @param num_threads Maximum number of threads used to compute the table.
+   * @return Whether the file was written.
+   */
+  static bool Write(const std::string& path, int num_threads = 1);
+
+  ~HctTable();
+  HctTable(const HctTable&) = delete;
+  HctTable& operator=(const HctTable&) = delete;
+
+  /**
+   * Returns the coordinates of `argb`, to the precision above.
+   */
+  HctCoordinates Get(Argb argb) const {
+    const uint16_t* entry = entries_ + 3 * (argb & 0xffffff);
+    return HctCoordinates{entry[0] * kHueStep, entry[1] * kChromaStep,
+                          entry[2] * kToneStep};
+  }
+
+ private:
+  static constexpr double kHueStep = 360.0 / 65536;
+  static constexpr double kChromaStep = 1.0 / 512;
+  static constexpr double kToneStep = 1.0 / 655.35;
+
+  HctTable(const void* mapping, size_t size);
+
+  const void* mapping_;
+  size_t size_;
+  const uint16_t* entries_;
+};
+
+/**
+ * Returns the HCT coordinates of `argb`: from `table` if it is given, to its
+ * precision, and otherwise computed exactly, as Hct(argb) does.
+ */
+HctCoordinates HctCoordinatesFromArgb(Argb argb, const HctTable* table);
+
+}  // namespace material_color_utilities
+
+#endif  // CPP_CAM_HCT_TABLE_H_
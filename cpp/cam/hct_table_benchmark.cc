@@ -0,0 +1,71 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "testing/base/public/benchmark.h"
+#include "cpp/cam/hct_table.h"
+#include "cpp/utils/utils.h"
+
+namespace material_color_utilities {
+
+namespace {
+
+constexpr int kColorCount = 4096;
+
+std::vector<Argb> Colors() {
+  std::vector<Argb> colors;
+  for (int i = 0; i < kColorCount; i++) {
+    colors.push_back(0xff000000 | ((i * 2654435761u) & 0xffffff));
+  }
+  return colors;
+}
+
+// Argument: whether to read the coordinates from a table, which is written
+// to a temporary file first, rather than compute them.
+void BM_HctCoordinatesFromArgb(benchmark::State& state) {
+  std::unique_ptr<HctTable> table;
+  std::string path =
+      (std::filesystem::temp_directory_path() / "hct_table_benchmark.table")
+          .string();
+  if (state.range(0)) {
+    if (!HctTable::Write(path)) {
+      state.SkipWithError("Could not write the table.");
+      return;
+    }
+    table = HctTable::Open(path);
+  }
+  std::vector<Argb> colors = Colors();
+  for (auto s : state) {
+    for (Argb argb : colors) {
+      benchmark::DoNotOptimize(HctCoordinatesFromArgb(argb, table.get()));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kColorCount);
+  state.SetLabel(table ? "table" : "exact");
+  if (table) {
+    table.reset();
+    remove(path.c_str());
+  }
+}
+BENCHMARK(BM_HctCoordinatesFromArgb)->Arg(0)->Arg(1);
+
+}  // namespace
+}  // namespace material_color_utilities
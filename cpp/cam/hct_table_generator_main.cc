@@ -0,0 +1,40 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Writes the table read by HctTable::Open.
+//
+// Usage: hct_table_generator <output file> [threads]
+
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+#include "cpp/cam/hct_table.h"
+
+int main(int argc, char** argv) {
+  if (argc < 2 || argc > 3) {
+    fprintf(stderr, "Usage: %s <output file> [threads]\n", argv[0]);
+    return 2;
+  }
+  int num_threads = argc == 3 ? atoi(argv[2])
+                              : static_cast<int>(
+                                    std::thread::hardware_concurrency());
+  if (!material_color_utilities::HctTable::Write(argv[1], num_threads)) {
+    fprintf(stderr, "Could not write %s\n", argv[1]);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpp/cam/hct_table.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include "testing/base/public/gunit.h"
+#include "cpp/cam/hct.h"
+#include "cpp/utils/utils.h"
+
+namespace material_color_utilities {
+
+namespace {
+
+class HctTableTest : public testing::Test {
+ protected:
+  // Writing the table converts every color, so it is written once for all
+  // tests.
+  static void SetUpTestSuite() {
+    path_ = new std::string(testing::TempDir() + "/hct_table_test.table");
+    ASSERT_TRUE(HctTable::Write(*path_, 4));
+  }
+
+  static void TearDownTestSuite() {
+    remove(path_->c_str());
+    delete path_;
+  }
+
+  static std::string* path_;
+};
+
+std::string* HctTableTest::path_ = nullptr;
+
+TEST_F(HctTableTest, MatchesHctWithinPrecisionBound) {
+  std::unique_ptr<HctTable> table = HctTable::Open(*path_);
+  ASSERT_NE(table, nullptr);
+  for (uint32_t rgb = 0; rgb <= 0xffffff; rgb += 97) {
+    Argb argb = 0xff000000 | rgb;
+    Hct hct(argb);
+    HctCoordinates coordinates = table->Get(argb);
+    EXPECT_LE(std::abs(DiffDegrees(coordinates.hue, hct.get_hue())), 0.0028)
+        << HexFromArgb(argb);
+    EXPECT_LE(std::abs(coordinates.chroma - hct.get_chroma()), 0.001)
+        << HexFromArgb(argb);
+    EXPECT_LE(std::abs(coordinates.tone - hct.get_tone()), 0.0008)
+        << HexFromArgb(argb);
+  }
+}
+
+TEST_F(HctTableTest, IgnoresAlpha) {
+  std::unique_ptr<HctTable> table = HctTable::Open(*path_);
+  ASSERT_NE(table, nullptr);
+  for (Argb argb : {0xff123456u, 0xffffffffu, 0xff000000u}) {
+    HctCoordinates opaque = table->Get(argb);
+    HctCoordinates transparent = table->Get(argb & 0x00ffffff);
+    EXPECT_EQ(opaque.hue, transparent.hue);
+    EXPECT_EQ(opaque.chroma, transparent.chroma);
+    EXPECT_EQ(opaque.tone, transparent.tone);
+  }
+}
+
+TEST_F(HctTableTest, CoordinatesFromArgbUseTableWhenGiven) {
+  std::unique_ptr<HctTable> table = HctTable::Open(*path_);
+  ASSERT_NE(table, nullptr);
+  Argb argb = 0xff4285f4;
+  HctCoordinates from_table = HctCoordinatesFromArgb(argb, table.get());
+  EXPECT_EQ(from_table.hue, table->Get(argb).hue);
+  EXPECT_EQ(from_table.chroma, table->Get(argb).chroma);
+  EXPECT_EQ(from_table.tone, table->Get(argb).tone);
+}
+
+TEST(HctTableFallbackTest, CoordinatesFromArgbAreExactWithoutTable) {
+  for (Argb argb : {0xff4285f4u, 0xff000000u, 0xffffffffu, 0xffe8def8u}) {
+    Hct hct(argb);
+    HctCoordinates coordinates = HctCoordinatesFromArgb(argb, nullptr);
+    EXPECT_EQ(coordinates.hue, hct.get_hue());
+    EXPECT_EQ(coordinates.chroma, hct.get_chroma());
+    EXPECT_EQ(coordinates.tone, hct.get_tone());
+  }
+}
+
+TEST(HctTableFallbackTest, OpenRejectsMissingAndInvalidFiles) {
+  EXPECT_EQ(HctTable::Open(testing::TempDir() + "/no_such_table"), nullptr);
+
+  std::string path = testing::TempDir() + "/invalid_hct_table";
+  int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  ASSERT_GE(fd, 0);
+  // Too short.
+  ASSERT_EQ(ftruncate(fd, 1000), 0);
+  EXPECT_EQ(HctTable::Open(path), nullptr);
+  // The size of a table, but with no header.
+  ASSERT_EQ(ftruncate(fd, 16 + (size_t{1} << 24) * 6), 0);
+  EXPECT_EQ(HctTable::Open(path), nullptr);
+  close(fd);
+  remove(path.c_str());
+}
+
+}  // namespace
+}  // namespace material_color_utilities
@@ -17,6 +17,8 @@
 #ifndef CPP_CAM_VIEWING_CONDITIONS_H_
 #define CPP_CAM_VIEWING_CONDITIONS_H_
 
+#include <math.h>
+
 namespace material_color_utilities {
 
 struct ViewingConditions {
@@ -46,7 +48,7 @@ ViewingConditions CreateViewingConditions(const double white_point[3],
 
 ViewingConditions DefaultWithBackgroundLstar(const double background_lstar);
 
-static const ViewingConditions kDefaultViewingConditions = (ViewingConditions){
+inline constexpr ViewingConditions kDefaultViewingConditions = {
     11.725676537,
     50.000000000,
     2.000000000,
@@ -64,5 +66,71 @@ static const ViewingConditions kDefaultViewingConditions = (ViewingConditions){
     {1.021177769, 0.986307740, 0.933960497},
 };
 
+/**
+ * The terms of a set of viewing conditions that the CAM16 transforms use,
+ * with those derived from its fields computed once, when the constants are
+ * created.
+ *
+ * The transforms are templates over the type of their constants, so that
+ * they can also be instantiated with DefaultViewingConstants, whose terms
+ * are known at compile time.
+ */
+struct ViewingConstants {
+  explicit ViewingConstants(const ViewingConditions& viewing_conditions)
+      : rgb_d{viewing_conditions.rgb_d[0], viewing_conditions.rgb_d[1],
+              viewing_conditions.rgb_d[2]},
+        fl(viewing_conditions.fl),
+        fl_root(viewing_conditions.fl_root),
+        aw(viewing_conditions.aw),
+        nbb(viewing_conditions.nbb),
+        ncb(viewing_conditions.ncb),
+        c(viewing_conditions.c),
+        n_c(viewing_conditions.n_c),
+        z(viewing_conditions.z),
+        n_factor(pow(
+            1.64 - pow(0.29, viewing_conditions.background_y_to_white_point_y),
+            0.73)),
+        t_inner_coeff(1 / n_factor),
+        j_exponent(1.0 / viewing_conditions.c / viewing_conditions.z) {}
+
+  double rgb_d[3];
+  double fl;
+  double fl_root;
+  double aw;
+  double nbb;
+  double ncb;
+  double c;
+  double n_c;
+  double z;
+  // pow(1.64 - pow(0.29, n), 0.73), where n is
+  // background_y_to_white_point_y; relates chroma to t in CAM16.
+  double n_factor;
+  // 1 / n_factor.
+  double t_inner_coeff;
+  // 1 / c / z, the exponent of J in the inverse transform.
+  double j_exponent;
+};
+
+/**
+ * The ViewingConstants of kDefaultViewingConditions, as compile-time
+ * constants.
+ */
+struct DefaultViewingConstants {
+  static constexpr const double* rgb_d = kDefaultViewingConditions.rgb_d;
+  static constexpr double fl = kDefaultViewingConditions.fl;
+  static constexpr double fl_root = kDefaultViewingConditions.fl_root;
+  static constexpr double aw = kDefaultViewingConditions.aw;
+  static constexpr double nbb = kDefaultViewingConditions.nbb;
+  static constexpr double ncb = kDefaultViewingConditions.ncb;
+  static constexpr double c = kDefaultViewingConditions.c;
+  static constexpr double n_c = kDefaultViewingConditions.n_c;
+  static constexpr double z = kDefaultViewingConditions.z;
+  // pow is not constexpr; this is the value it returns, to the bit, as
+  // checked by the tests.
+  static constexpr double n_factor = 0x1.c453e4b1a81e3p-1;
+  static constexpr double t_inner_coeff = 1 / n_factor;
+  static constexpr double j_exponent = 1.0 / c / z;
+};
+
 }  // namespace material_color_utilities
 #endif  // CPP_CAM_VIEWING_CONDITIONS_H_
@@ -17,44 +17,159 @@
 #include "cpp/quantize/celebi.h"
 
 #include <cstddef>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
+#include <random>
 #include <vector>
 
+#include "cpp/quantize/pixel_view.h"
 #include "cpp/quantize/wsmeans.h"
 #include "cpp/quantize/wu.h"
 #include "cpp/utils/utils.h"
 
 namespace material_color_utilities {
 
+/**
+ * Returns a uniformly distributed integer in [0, bound), computed the same
+ * way on every platform, unlike std::uniform_int_distribution.
+ */
+size_t RandomIndex(std::mt19937& random, size_t bound) {
+  return (static_cast<uint64_t>(random()) * bound) >> 32;
+}
+
+/**
+ * Copies a sample of `budget` of the opaque pixels to quantize into
+ * `opaque_pixels`, chosen as `options` says.
+ */
+void SampleOpaquePixels(const PixelView& pixels, size_t budget,
+                        const CelebiOptions& options,
+                        std::vector<Argb>& opaque_pixels) {
+  size_t pixel_count = pixels.pixel_count();
+  opaque_pixels.reserve(budget);
+  std::mt19937 random(options.seed);
+  switch (options.sampling) {
+    case CelebiSampling::kStride:
+      // Transparent pixels still use up part of the budget, so the sample
+      // keeps the image's proportion of opaque pixels.
+      for (size_t i = 0; i < budget; i++) {
+        Argb pixel = pixels.At(i * pixel_count / budget);
+        if (IsOpaque(pixel)) {
+          opaque_pixels.push_back(pixel);
+        }
+      }
+      break;
+    case CelebiSampling::kRandom:
+      for (size_t i = 0; i < budget; i++) {
+        Argb pixel = pixels.At(RandomIndex(random, pixel_count));
+        if (IsOpaque(pixel)) {
+          opaque_pixels.push_back(pixel);
+        }
+      }
+      break;
+    case CelebiSampling::kReservoir: {
+      // Algorithm R: after n opaque pixels, each has been kept with
+      // probability budget / n.
+      PixelView opaque = pixels;
+      opaque.opaque_only = true;
+      size_t seen = 0;
+      ForEachPixel(opaque, [&](Argb pixel) {
+        seen++;
+        if (opaque_pixels.size() < budget) {
+          opaque_pixels.push_back(pixel);
+          return;
+        }
+        size_t slot = RandomIndex(random, seen);
+        if (slot < budget) {
+          opaque_pixels[slot] = pixel;
+        }
+      });
+      break;
+    }
+  }
+}
+
 QuantizerResult QuantizeCelebi(const std::vector<Argb>& pixels,
                                uint16_t max_colors) {
-  if (max_colors == 0 || pixels.empty()) {
-    return QuantizerResult();
+  return QuantizeCelebi(pixels, max_colors, CelebiOptions());
+}
+
+QuantizerResult QuantizeCelebi(const std::vector<Argb>& pixels,
+                               uint16_t max_colors,
+                               const CelebiOptions& options) {
+  FlatQuantizerResult result;
+  QuantizeCelebi(pixels, max_colors, options, &result);
+  return ToQuantizerResult(result);
+}
+
+void QuantizeCelebi(const std::vector<Argb>& pixels, uint16_t max_colors,
+                    FlatQuantizerResult* result) {
+  QuantizeCelebi(pixels, max_colors, CelebiOptions(), result);
+}
+
+void QuantizeCelebi(const std::vector<Argb>& pixels, uint16_t max_colors,
+                    const CelebiOptions& options, FlatQuantizerResult* result) {
+  QuantizeCelebi(PixelView(pixels), max_colors, options, result);
+}
+
+QuantizerResult QuantizeCelebi(const PixelView& pixels, uint16_t max_colors,
+                               const CelebiOptions& options) {
+  FlatQuantizerResult result;
+  QuantizeCelebi(pixels, max_colors, options, &result);
+  return ToQuantizerResult(result);
+}
+
+void QuantizeCelebi(const PixelView& pixels, uint16_t max_colors,
+                    const CelebiOptions& options, FlatQuantizerResult* result,
+                    CelebiWorkspace* workspace) {
+  QuantizeCelebi(pixels, std::vector<Argb>(), max_colors, options, result,
+                 workspace);
+}
+
+void QuantizeCelebi(const PixelView& pixels,
+                    const std::vector<Argb>& starting_clusters,
+                    uint16_t max_colors, const CelebiOptions& options,
+                    FlatQuantizerResult* result, CelebiWorkspace* workspace,
+                    WsmeansStats* stats) {
+  if (max_colors == 0 || pixels.pixel_count() == 0) {
+    result->Clear();
+    if (stats != nullptr) {
+      *stats = WsmeansStats();
+    }
+    return;
   }
 
   if (max_colors > 256) {
     max_colors = 256;
   }
 
-  int pixel_count = pixels.size();
+  CelebiWorkspace local_workspace;
+  if (workspace == nullptr) {
+    workspace = &local_workspace;
+  }
 
-  std::vector<Argb> opaque_pixels;
-  opaque_pixels.reserve(pixel_count);
-  for (int i = 0; i < pixel_count; i++) {
-    int pixel = pixels[i];
-    if (!IsOpaque(pixel)) {
-      continue;
-    }
-    opaque_pixels.push_back(pixel);
+  // Unless the image must be subsampled, both passes read the opaque pixels
+  // in place.
+  size_t budget = options.pixel_budget;
+  PixelView opaque_pixels = pixels;
+  opaque_pixels.opaque_only = true;
+  if (budget != 0 && pixels.pixel_count() > budget) {
+    workspace->sampled_pixels_.clear();
+    SampleOpaquePixels(pixels, budget, options, workspace->sampled_pixels_);
+    opaque_pixels = PixelView(workspace->sampled_pixels_);
   }
 
-  std::vector<Argb> wu_result = QuantizeWu(opaque_pixels, max_colors);
+  if (!starting_clusters.empty()) {
+    QuantizeWsmeans(opaque_pixels, starting_clusters, max_colors,
+                    options.wsmeans, result, &workspace->wsmeans_, stats);
+    return;
+  }
 
-  QuantizerResult result =
-      QuantizeWsmeans(opaque_pixels, wu_result, max_colors);
+  std::vector<Argb> wu_result =
+      QuantizeWu(opaque_pixels, max_colors, options.wu, &workspace->wu_);
 
-  return result;
+  QuantizeWsmeans(opaque_pixels, wu_result, max_colors, options.wsmeans,
+                  result, &workspace->wsmeans_, stats);
 }
 
 }  // namespace material_color_utilities
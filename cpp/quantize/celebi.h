@@ -22,14 +22,117 @@
 
 #include <vector>
 
+#include "cpp/quantize/pixel_view.h"
 #include "cpp/quantize/wsmeans.h"
+#include "cpp/quantize/wu.h"
 #include "cpp/utils/utils.h"
 
 namespace material_color_utilities {
 
+/**
+ * How QuantizeCelebi picks pixels when the input exceeds its pixel budget.
+ * `kStride`: evenly spaced pixels, in input order.
+ * `kRandom`: uniformly random pixels, with replacement.
+ * `kReservoir`: a uniformly random subset of the opaque pixels, without
+ *               replacement.
+ */
+enum class CelebiSampling {
+  kStride,
+  kRandom,
+  kReservoir,
+};
+
+/**
+ * Options for QuantizeCelebi.
+ * `pixel_budget`: the maximum number of pixels quantized; larger inputs are
+ *                 subsampled. 0 quantizes every pixel. Populations in the
+ *                 result count sampled pixels only.
+ * `sampling`: how pixels are picked when subsampling.
+ * `seed`: seed for the random sampling strategies. The same seed and input
+ *         always give the same sample.
+ * `wu`: options for the Wu quantizer that picks WSMeans' starting clusters,
+ *       e.g. threads to build its histogram of a large image.
+ * `wsmeans`: options for the WSMeans refinement, e.g. an iteration or time
+ *            budget for interactive use.
+ */
+struct CelebiOptions {
+  size_t pixel_budget = 0;
+  CelebiSampling sampling = CelebiSampling::kStride;
+  uint32_t seed = 42688;
+  WuOptions wu;
+  WsmeansOptions wsmeans;
+};
+
 QuantizerResult QuantizeCelebi(const std::vector<Argb>& pixels,
                                uint16_t max_colors);
 
+QuantizerResult QuantizeCelebi(const std::vector<Argb>& pixels,
+                               uint16_t max_colors,
+                               const CelebiOptions& options);
+
+/**
+ * Variant of QuantizeCelebi that writes its result to sorted arrays,
+ * reusing the storage already held by `result`.
+ */
+void QuantizeCelebi(const std::vector<Argb>& pixels, uint16_t max_colors,
+                    FlatQuantizerResult* result);
+
+void QuantizeCelebi(const std::vector<Argb>& pixels, uint16_t max_colors,
+                    const CelebiOptions& options, FlatQuantizerResult* result);
+
+/**
+ * Variants of QuantizeCelebi that read pixels in place from a caller-owned
+ * image, e.g. an RGBA or BGRA frame with padded rows. Transparent pixels are
+ * skipped while the image is read, so it is never copied unless it must be
+ * subsampled.
+ */
+QuantizerResult QuantizeCelebi(const PixelView& pixels, uint16_t max_colors,
+                               const CelebiOptions& options = {});
+
+class CelebiWorkspace;
+
+/**
+ * @param workspace If given, holds storage between calls, so that repeated
+ *                  calls stop allocating. May be null.
+ */
+void QuantizeCelebi(const PixelView& pixels, uint16_t max_colors,
+                    const CelebiOptions& options, FlatQuantizerResult* result,
+                    CelebiWorkspace* workspace = nullptr);
+
+/**
+ * Variant of QuantizeCelebi that starts WSMeans from `starting_clusters`,
+ * e.g. the palette of a previous, similar image, instead of from Wu's
+ * palette. With no starting clusters, Wu runs as usual.
+ *
+ * @param stats If given, receives WSMeans's statistics. May be null.
+ */
+void QuantizeCelebi(const PixelView& pixels,
+                    const std::vector<Argb>& starting_clusters,
+                    uint16_t max_colors, const CelebiOptions& options,
+                    FlatQuantizerResult* result,
+                    CelebiWorkspace* workspace = nullptr,
+                    WsmeansStats* stats = nullptr);
+
+/**
+ * Storage used by QuantizeCelebi, owned by the caller and reused across
+ * calls: the Wu histogram, the WSMeans workspace and any subsampled pixels.
+ *
+ * A workspace must not be used by two calls at once.
+ */
+class CelebiWorkspace {
+ private:
+  WuWorkspace wu_;
+  WsmeansWorkspace wsmeans_;
+  std::vector<Argb> sampled_pixels_;
+
+  friend void QuantizeCelebi(const PixelView& pixels,
+                             const std::vector<Argb>& starting_clusters,
+                             uint16_t max_colors,
+                             const CelebiOptions& options,
+                             FlatQuantizerResult* result,
+                             CelebiWorkspace* workspace, WsmeansStats* stats);
+};
+
 }  // namespace material_color_utilities
 
 #endif  // CPP_QUANTIZE_CELEBI_H_
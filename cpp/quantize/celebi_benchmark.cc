@@ -0,0 +1,92 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "testing/base/public/benchmark.h"
+#include "cpp/cam/hct.h"
+#include "cpp/quantize/celebi.h"
+#include "cpp/quantize/synthetic_images.h"
+#include "cpp/quantize/wsmeans.h"
+#include "cpp/score/score.h"
+#include "cpp/utils/utils.h"
+
+namespace material_color_utilities {
+
+namespace {
+
+constexpr int kImageSize = 512;
+
+const std::vector<SyntheticImage>& Corpus() {
+  static const std::vector<SyntheticImage>* corpus =
+      new std::vector<SyntheticImage>(
+          SyntheticImageCorpus(kImageSize, kImageSize));
+  return *corpus;
+}
+
+std::vector<Argb> Suggestions(const std::vector<Argb>& pixels,
+                              const CelebiOptions& options) {
+  FlatQuantizerResult result;
+  QuantizeCelebi(pixels, 128, options, &result);
+  return RankedSuggestions(result.colors, result.populations);
+}
+
+// Arguments: sampling strategy, pixel budget (0 for every pixel).
+//
+// Besides timing, reports how far the sampled result drifts from the
+// full-resolution one over the corpus:
+// `top_hue_drift`: mean hue difference of the top suggestion, in degrees.
+// `max_top_hue_drift`: the largest such difference.
+// `top_match`: fraction of images whose top suggestion is unchanged.
+void BM_QuantizeCelebiSampled(benchmark::State& state) {
+  CelebiOptions options;
+  options.sampling = static_cast<CelebiSampling>(state.range(0));
+  options.pixel_budget = state.range(1);
+  for (auto s : state) {
+    for (const SyntheticImage& image : Corpus()) {
+      FlatQuantizerResult result;
+      QuantizeCelebi(image.pixels, 128, options, &result);
+      benchmark::DoNotOptimize(result.colors.data());
+    }
+  }
+
+  double drift_sum = 0.0;
+  double drift_max = 0.0;
+  int matches = 0;
+  for (const SyntheticImage& image : Corpus()) {
+    Argb full = Suggestions(image.pixels, CelebiOptions())[0];
+    Argb sampled = Suggestions(image.pixels, options)[0];
+    double drift = DiffDegrees(Hct(full).get_hue(), Hct(sampled).get_hue());
+    drift_sum += drift;
+    drift_max = std::max(drift_max, drift);
+    matches += full == sampled;
+  }
+  state.counters["top_hue_drift"] = drift_sum / Corpus().size();
+  state.counters["max_top_hue_drift"] = drift_max;
+  state.counters["top_match"] = static_cast<double>(matches) / Corpus().size();
+}
+BENCHMARK(BM_QuantizeCelebiSampled)
+    ->Args({static_cast<int>(CelebiSampling::kStride), 0})
+    ->ArgsProduct({{static_cast<int>(CelebiSampling::kStride),
+                    static_cast<int>(CelebiSampling::kRandom),
+                    static_cast<int>(CelebiSampling::kReservoir)},
+                   {16384, 65536}})
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace material_color_utilities
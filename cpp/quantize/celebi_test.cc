@@ -20,6 +20,11 @@
 #include <vector>
 
 #include "testing/base/public/gunit.h"
+#include "cpp/cam/hct.h"
+#include "cpp/quantize/pixel_view.h"
+#include "cpp/quantize/synthetic_images.h"
+#include "cpp/score/score.h"
+#include "cpp/utils/utils.h"
 
 namespace material_color_utilities {
 
@@ -127,5 +132,172 @@ TEST(CelebiTest, TooManyColors) {
   EXPECT_TRUE(result.input_pixel_to_cluster_pixel.empty());
 }
 
+TEST(CelebiTest, FlatResultReusesStorage) {
+  std::vector<Argb> pixels;
+  for (int i = 0; i < 1000; i++) {
+    pixels.push_back(0xff000000 | (i * 997));
+  }
+  FlatQuantizerResult result;
+  QuantizeCelebi(pixels, 128, &result);
+  QuantizerResult legacy = QuantizeCelebi(pixels, 128);
+  EXPECT_EQ(ToQuantizerResult(result).color_to_count, legacy.color_to_count);
+
+  const Argb* input_pixels_data = result.input_pixels.data();
+  QuantizeCelebi(pixels, 128, &result);
+  EXPECT_EQ(result.input_pixels.data(), input_pixels_data);
+}
+
+TEST(CelebiTest, NoBudgetUsesEveryPixel) {
+  std::vector<Argb> pixels;
+  for (int i = 0; i < 1000; i++) {
+    pixels.push_back(0xff000000 | (i * 997));
+  }
+  for (CelebiSampling sampling :
+       {CelebiSampling::kStride, CelebiSampling::kRandom,
+        CelebiSampling::kReservoir}) {
+    CelebiOptions options;
+    options.sampling = sampling;
+    EXPECT_EQ(QuantizeCelebi(pixels, 128, options).color_to_count,
+              QuantizeCelebi(pixels, 128).color_to_count);
+    options.pixel_budget = pixels.size();
+    EXPECT_EQ(QuantizeCelebi(pixels, 128, options).color_to_count,
+              QuantizeCelebi(pixels, 128).color_to_count);
+  }
+}
+
+TEST(CelebiTest, SamplingRespectsBudget) {
+  std::vector<Argb> pixels;
+  for (int i = 0; i < 10000; i++) {
+    pixels.push_back(i % 2 == 0 ? 0xffff0000 : 0x00ff0000);
+  }
+  for (CelebiSampling sampling :
+       {CelebiSampling::kStride, CelebiSampling::kRandom,
+        CelebiSampling::kReservoir}) {
+    CelebiOptions options;
+    options.sampling = sampling;
+    options.pixel_budget = 100;
+    QuantizerResult result = QuantizeCelebi(pixels, 16, options);
+    ASSERT_EQ(result.color_to_count.size(), 1u);
+    EXPECT_LE(result.color_to_count[0xffff0000], 100u);
+  }
+}
+
+TEST(CelebiTest, ReservoirSamplesExactlyBudgetOpaquePixels) {
+  std::vector<Argb> pixels;
+  for (int i = 0; i < 10000; i++) {
+    pixels.push_back(i % 3 == 0 ? 0xff00ff00 : 0x0000ff00);
+  }
+  CelebiOptions options;
+  options.sampling = CelebiSampling::kReservoir;
+  options.pixel_budget = 500;
+  QuantizerResult result = QuantizeCelebi(pixels, 16, options);
+  EXPECT_EQ(result.color_to_count[0xff00ff00], 500u);
+}
+
+TEST(CelebiTest, RandomSamplingIsReproducible) {
+  std::vector<Argb> pixels;
+  for (int i = 0; i < 20000; i++) {
+    pixels.push_back(0xff000000 | ((i * 2654435761u) & 0xffffff));
+  }
+  for (CelebiSampling sampling :
+       {CelebiSampling::kRandom, CelebiSampling::kReservoir}) {
+    CelebiOptions options;
+    options.sampling = sampling;
+    options.pixel_budget = 2000;
+    EXPECT_EQ(QuantizeCelebi(pixels, 32, options).color_to_count,
+              QuantizeCelebi(pixels, 32, options).color_to_count);
+  }
+}
+
+TEST(CelebiTest, RgbaViewMatchesArgbPixels) {
+  for (const SyntheticImage& image : SyntheticImageCorpus(60, 40)) {
+    // Rows padded to 256 bytes, as a decoder with aligned rows produces.
+    constexpr size_t kStride = 256;
+    std::vector<uint8_t> rgba(kStride * image.height, 0xee);
+    for (int y = 0; y < image.height; y++) {
+      for (int x = 0; x < image.width; x++) {
+        Argb argb = image.pixels[y * image.width + x];
+        uint8_t* bytes = &rgba[y * kStride + 4 * x];
+        bytes[0] = RedFromInt(argb);
+        bytes[1] = GreenFromInt(argb);
+        bytes[2] = BlueFromInt(argb);
+        bytes[3] = AlphaFromInt(argb);
+      }
+    }
+    PixelView view(rgba.data(), image.width, image.height, kStride,
+                   PixelFormat::kRgba8888);
+    for (size_t budget : {0, 500}) {
+      for (CelebiSampling sampling :
+           {CelebiSampling::kStride, CelebiSampling::kReservoir}) {
+        CelebiOptions options;
+        options.pixel_budget = budget;
+        options.sampling = sampling;
+        QuantizerResult expected = QuantizeCelebi(image.pixels, 16, options);
+        QuantizerResult result = QuantizeCelebi(view, 16, options);
+        EXPECT_EQ(result.color_to_count, expected.color_to_count)
+            << image.name;
+        EXPECT_EQ(result.input_pixel_to_cluster_pixel,
+                  expected.input_pixel_to_cluster_pixel)
+            << image.name;
+      }
+    }
+  }
+}
+
+TEST(CelebiTest, SampledSuggestionsStayCloseToFullResolution) {
+  for (const SyntheticImage& image : SyntheticImageCorpus(128, 128)) {
+    if (image.name == "noise") {
+      // Every hue is equally likely to come first.
+      continue;
+    }
+    Argb full = RankedSuggestions(
+        QuantizeCelebi(image.pixels, 128).color_to_count)[0];
+    for (CelebiSampling sampling :
+         {CelebiSampling::kStride, CelebiSampling::kRandom,
+          CelebiSampling::kReservoir}) {
+      CelebiOptions options;
+      options.sampling = sampling;
+      options.pixel_budget = image.pixels.size() / 4;
+      Argb sampled = RankedSuggestions(
+          QuantizeCelebi(image.pixels, 128, options).color_to_count)[0];
+      EXPECT_LT(DiffDegrees(Hct(full).get_hue(), Hct(sampled).get_hue()),
+                10.0)
+          << image.name << " sampling " << static_cast<int>(sampling);
+    }
+  }
+}
+
+TEST(CelebiTest, Float32PrecisionKeepsTopSuggestion) {
+  // Single-precision clustering shifts palette colors by far less than the
+  // distance between the candidates RankedSuggestions chooses from.
+  for (int size : {128, 256}) {
+    for (const SyntheticImage& image : SyntheticImageCorpus(size, size)) {
+      std::vector<Argb> expected =
+          RankedSuggestions(QuantizeCelebi(image.pixels, 128).color_to_count);
+      CelebiOptions options;
+      options.wsmeans.precision = WsmeansPrecision::kFloat32;
+      std::vector<Argb> suggestions = RankedSuggestions(
+          QuantizeCelebi(image.pixels, 128, options).color_to_count);
+      ASSERT_FALSE(suggestions.empty()) << image.name;
+      EXPECT_EQ(suggestions[0], expected[0]) << image.name << " " << size;
+    }
+  }
+}
+
+TEST(CelebiTest, ForwardsWsmeansOptions) {
+  std::vector<Argb> pixels(20000);
+  for (size_t i = 0; i < pixels.size(); i++) {
+    pixels[i] = 0xff000000 | ((i * 2654435761u) & 0xffffff);
+  }
+  FlatQuantizerResult result;
+  CelebiOptions options;
+  QuantizeCelebi(PixelView(pixels), 64, options, &result);
+  EXPECT_TRUE(result.converged);
+
+  options.wsmeans.max_iterations = 1;
+  QuantizeCelebi(PixelView(pixels), 64, options, &result);
+  EXPECT_FALSE(result.converged);
+}
+
 }  // namespace
 }  // namespace material_color_utilities
@@ -18,10 +18,71 @@
 
 #include <math.h>
 
+#include <cstdint>
+#include <cstring>
+
+#include "absl/types/span.h"
+#include "cpp/utils/simd.h"
 #include "cpp/utils/utils.h"
 
+#ifdef MCU_HAS_X86_KERNELS
+#include <immintrin.h>
+#endif
+
 namespace material_color_utilities {
 
+namespace {
+
+constexpr double kLabE = 216.0 / 24389.0;
+constexpr double kLabKappa = 24389.0 / 27.0;
+
+/**
+ * Returns an estimate of the cube root of a positive number within a few
+ * percent, by dividing its binary exponent by three.
+ */
+inline double CubeRootEstimate(double x) {
+  uint64_t bits;
+  memcpy(&bits, &x, sizeof(bits));
+  // Two thirds of the bit pattern of 1.0, so that the estimate for 1 is 1.
+  bits = bits / 3 + 0x2aa0000000000000;
+  double estimate;
+  memcpy(&estimate, &bits, sizeof(estimate));
+  return estimate;
+}
+
+/**
+ * Refines a cube root estimate with one step of Halley's method, which
+ * triples the number of correct digits.
+ */
+inline double RefineCubeRoot(double x, double y) {
+  double y3 = y * y * y;
+  return y * (y3 + 2.0 * x) / (2.0 * y3 + x);
+}
+
+/**
+ * Cube root of a positive number. Three Halley steps from the exponent
+ * estimate reach double precision, at a fraction of the cost of pow().
+ */
+inline double CubeRoot(double x) {
+  double y = CubeRootEstimate(x);
+  y = RefineCubeRoot(x, y);
+  y = RefineCubeRoot(x, y);
+  return RefineCubeRoot(x, y);
+}
+
+/**
+ * The L*a*b* transfer function, f(t).
+ */
+inline double LabF(double t) {
+  if (t > kLabE) {
+    return CubeRoot(t);
+  } else {
+    return (kLabKappa * t + 16) / 116;
+  }
+}
+
+}  // namespace
+
 Argb IntFromLab(const Lab lab) {
   double e = 216.0 / 24389.0;
   double kappa = 24389.0 / 27.0;
@@ -61,36 +122,118 @@ Lab LabFromInt(const Argb argb) {
   double x = 0.41233895 * red_l + 0.35762064 * green_l + 0.18051042 * blue_l;
   double y = 0.2126 * red_l + 0.7152 * green_l + 0.0722 * blue_l;
   double z = 0.01932141 * red_l + 0.11916382 * green_l + 0.95034478 * blue_l;
-  double y_normalized = y / kWhitePointD65[1];
-  double e = 216.0 / 24389.0;
-  double kappa = 24389.0 / 27.0;
-  double fy;
-  if (y_normalized > e) {
-    fy = pow(y_normalized, 1.0 / 3.0);
-  } else {
-    fy = (kappa * y_normalized + 16) / 116;
+  double fx = LabF(x / kWhitePointD65[0]);
+  double fy = LabF(y / kWhitePointD65[1]);
+  double fz = LabF(z / kWhitePointD65[2]);
+
+  double l = 116.0 * fy - 16;
+  double a = 500.0 * (fx - fy);
+  double b = 200.0 * (fy - fz);
+  return {l, a, b};
+}
+
+#ifdef MCU_HAS_X86_KERNELS
+
+namespace {
+
+__attribute__((target("avx2"))) inline __m256d Avx2LabF(__m256d t) {
+  // Cube roots of all four lanes, with the estimates made one lane at a time.
+  alignas(32) double lanes[4];
+  _mm256_store_pd(lanes, t);
+  __m256d y = _mm256_setr_pd(
+      CubeRootEstimate(lanes[0]), CubeRootEstimate(lanes[1]),
+      CubeRootEstimate(lanes[2]), CubeRootEstimate(lanes[3]));
+  __m256d two = _mm256_set1_pd(2.0);
+  for (int i = 0; i < 3; i++) {
+    __m256d y3 = _mm256_mul_pd(_mm256_mul_pd(y, y), y);
+    __m256d numerator =
+        _mm256_mul_pd(y, _mm256_add_pd(y3, _mm256_mul_pd(two, t)));
+    __m256d denominator = _mm256_add_pd(_mm256_mul_pd(two, y3), t);
+    y = _mm256_div_pd(numerator, denominator);
   }
+  __m256d linear = _mm256_div_pd(
+      _mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(kLabKappa), t),
+                    _mm256_set1_pd(16.0)),
+      _mm256_set1_pd(116.0));
+  __m256d is_cubic = _mm256_cmp_pd(t, _mm256_set1_pd(kLabE), _CMP_GT_OQ);
+  return _mm256_blendv_pd(linear, y, is_cubic);
+}
 
-  double x_normalized = x / kWhitePointD65[0];
-  double fx;
-  if (x_normalized > e) {
-    fx = pow(x_normalized, 1.0 / 3.0);
-  } else {
-    fx = (kappa * x_normalized + 16) / 116;
+__attribute__((target("avx2"))) inline __m256d Avx2Dot(
+    double k_r, double k_g, double k_b, __m256d r, __m256d g, __m256d b) {
+  return _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(k_r), r),
+                                     _mm256_mul_pd(_mm256_set1_pd(k_g), g)),
+                       _mm256_mul_pd(_mm256_set1_pd(k_b), b));
+}
+
+template <typename T>
+__attribute__((target("avx2"))) size_t Avx2LabFromInts(const Argb* argbs,
+                                                        BasicLab<T>* labs,
+                                                        size_t count) {
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    alignas(32) double red_l[4];
+    alignas(32) double green_l[4];
+    alignas(32) double blue_l[4];
+    for (int lane = 0; lane < 4; lane++) {
+      Argb argb = argbs[i + lane];
+      red_l[lane] = Linearized((argb & 0x00ff0000) >> 16);
+      green_l[lane] = Linearized((argb & 0x0000ff00) >> 8);
+      blue_l[lane] = Linearized(argb & 0x000000ff);
+    }
+    __m256d r = _mm256_load_pd(red_l);
+    __m256d g = _mm256_load_pd(green_l);
+    __m256d b = _mm256_load_pd(blue_l);
+    __m256d x = Avx2Dot(0.41233895, 0.35762064, 0.18051042, r, g, b);
+    __m256d y = Avx2Dot(0.2126, 0.7152, 0.0722, r, g, b);
+    __m256d z = Avx2Dot(0.01932141, 0.11916382, 0.95034478, r, g, b);
+    __m256d fx = Avx2LabF(_mm256_div_pd(x, _mm256_set1_pd(kWhitePointD65[0])));
+    __m256d fy = Avx2LabF(_mm256_div_pd(y, _mm256_set1_pd(kWhitePointD65[1])));
+    __m256d fz = Avx2LabF(_mm256_div_pd(z, _mm256_set1_pd(kWhitePointD65[2])));
+
+    alignas(32) double l[4];
+    alignas(32) double a[4];
+    alignas(32) double bb[4];
+    _mm256_store_pd(l, _mm256_sub_pd(_mm256_mul_pd(_mm256_set1_pd(116.0), fy),
+                                     _mm256_set1_pd(16.0)));
+    _mm256_store_pd(a, _mm256_mul_pd(_mm256_set1_pd(500.0),
+                                     _mm256_sub_pd(fx, fy)));
+    _mm256_store_pd(bb, _mm256_mul_pd(_mm256_set1_pd(200.0),
+                                      _mm256_sub_pd(fy, fz)));
+    for (int lane = 0; lane < 4; lane++) {
+      labs[i + lane] = LabCast<T>(Lab{l[lane], a[lane], bb[lane]});
+    }
   }
+  return i;
+}
 
-  double z_normalized = z / kWhitePointD65[2];
-  double fz;
-  if (z_normalized > e) {
-    fz = pow(z_normalized, 1.0 / 3.0);
-  } else {
-    fz = (kappa * z_normalized + 16) / 116;
+}  // namespace
+
+#endif  // MCU_HAS_X86_KERNELS
+
+namespace {
+
+template <typename T>
+void ConvertLabs(absl::Span<const Argb> argbs, absl::Span<BasicLab<T>> labs) {
+  size_t converted = 0;
+#ifdef MCU_HAS_X86_KERNELS
+  if (BestSimdLevel() == SimdLevel::kAvx2) {
+    converted = Avx2LabFromInts(argbs.data(), labs.data(), argbs.size());
   }
+#endif
+  for (size_t i = converted; i < argbs.size(); i++) {
+    labs[i] = LabCast<T>(LabFromInt(argbs[i]));
+  }
+}
 
-  double l = 116.0 * fy - 16;
-  double a = 500.0 * (fx - fy);
-  double b = 200.0 * (fy - fz);
-  return {l, a, b};
+}  // namespace
+
+void LabFromInts(absl::Span<const Argb> argbs, absl::Span<Lab> labs) {
+  ConvertLabs(argbs, labs);
+}
+
+void LabFromInts(absl::Span<const Argb> argbs, absl::Span<LabFloat> labs) {
+  ConvertLabs(argbs, labs);
 }
 
 }  // namespace material_color_utilities
@@ -28,19 +28,26 @@
 #include <unordered_set>
 #include <vector>
 
+#include "absl/types/span.h"
 #include "cpp/utils/utils.h"
 
 namespace material_color_utilities {
 
-struct Lab {
-  double l = 0.0;
-  double a = 0.0;
-  double b = 0.0;
+/**
+ * A color in L*a*b*, with components of type T. Lab, in double precision, is
+ * used throughout; LabFloat halves the memory per color where single
+ * precision is enough, e.g. when clustering many colors.
+ */
+template <typename T>
+struct BasicLab {
+  T l = 0;
+  T a = 0;
+  T b = 0;
 
-  double DeltaE(const Lab& lab) {
-    double d_l = l - lab.l;
-    double d_a = a - lab.a;
-    double d_b = b - lab.b;
+  T DeltaE(const BasicLab& lab) const {
+    T d_l = l - lab.l;
+    T d_a = a - lab.a;
+    T d_b = b - lab.b;
     return (d_l * d_l) + (d_a * d_a) + (d_b * d_b);
   }
 
@@ -50,8 +57,43 @@ struct Lab {
   }
 };
 
+using Lab = BasicLab<double>;
+using LabFloat = BasicLab<float>;
+
+/**
+ * Converts a color between precisions.
+ */
+template <typename To, typename From>
+BasicLab<To> LabCast(const BasicLab<From>& lab) {
+  return {static_cast<To>(lab.l), static_cast<To>(lab.a),
+          static_cast<To>(lab.b)};
+}
+
 Argb IntFromLab(const Lab lab);
+
+/**
+ * Converts a color from ARGB to L*a*b*.
+ *
+ * Linearization uses a precomputed table and cube roots use a fast iterative
+ * method; each component is within 1e-10 of the result computed with pow().
+ */
 Lab LabFromInt(const Argb argb);
 
+/**
+ * Converts many colors from ARGB to L*a*b*, using vector instructions where
+ * the CPU supports them. Each component is within 1e-12 of LabFromInt's, as
+ * the vector code may round intermediate results differently.
+ *
+ * @param argbs Colors to convert.
+ * @param labs Output; must be at least as long as argbs.
+ */
+void LabFromInts(absl::Span<const Argb> argbs, absl::Span<Lab> labs);
+
+/**
+ * Single-precision variant of LabFromInts. Each component is LabFromInt's,
+ * rounded to float.
+ */
+void LabFromInts(absl::Span<const Argb> argbs, absl::Span<LabFloat> labs);
+
 }  // namespace material_color_utilities
 #endif  // CPP_QUANTIZE_LAB_H_
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <math.h>
+
+#include <vector>
+
+#include "testing/base/public/benchmark.h"
+#include "cpp/quantize/lab.h"
+#include "cpp/utils/utils.h"
+
+namespace material_color_utilities {
+
+namespace {
+
+constexpr int kColorCount = 1 << 16;
+
+std::vector<Argb> SpreadColors() {
+  std::vector<Argb> argbs;
+  for (int i = 0; i < kColorCount; i++) {
+    argbs.push_back(0xff000000 | ((i * 2654435761u) & 0xffffff));
+  }
+  return argbs;
+}
+
+// The conversion as it was before the table and iterative cube root, for
+// comparison.
+void BM_LabFromIntPow(benchmark::State& state) {
+  std::vector<Argb> argbs = SpreadColors();
+  for (auto s : state) {
+    for (Argb argb : argbs) {
+      double red_l = Linearized(RedFromInt(argb));
+      double green_l = Linearized(GreenFromInt(argb));
+      double blue_l = Linearized(BlueFromInt(argb));
+      double y = 0.2126 * red_l + 0.7152 * green_l + 0.0722 * blue_l;
+      double x =
+          0.41233895 * red_l + 0.35762064 * green_l + 0.18051042 * blue_l;
+      double z =
+          0.01932141 * red_l + 0.11916382 * green_l + 0.95034478 * blue_l;
+      benchmark::DoNotOptimize(pow(x / kWhitePointD65[0], 1.0 / 3.0));
+      benchmark::DoNotOptimize(pow(y / kWhitePointD65[1], 1.0 / 3.0));
+      benchmark::DoNotOptimize(pow(z / kWhitePointD65[2], 1.0 / 3.0));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kColorCount);
+}
+BENCHMARK(BM_LabFromIntPow);
+
+void BM_LabFromInt(benchmark::State& state) {
+  std::vector<Argb> argbs = SpreadColors();
+  for (auto s : state) {
+    for (Argb argb : argbs) {
+      benchmark::DoNotOptimize(LabFromInt(argb));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kColorCount);
+}
+BENCHMARK(BM_LabFromInt);
+
+void BM_LabFromInts(benchmark::State& state) {
+  std::vector<Argb> argbs = SpreadColors();
+  std::vector<Lab> labs(argbs.size());
+  for (auto s : state) {
+    LabFromInts(argbs, absl::MakeSpan(labs));
+    benchmark::DoNotOptimize(labs.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kColorCount);
+}
+BENCHMARK(BM_LabFromInts);
+
+}  // namespace
+}  // namespace material_color_utilities
@@ -0,0 +1,162 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpp/quantize/lab_distance.h"
+
+#include "cpp/utils/simd.h"
+
+#ifdef MCU_HAS_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace material_color_utilities {
+
+namespace {
+
+template <typename T>
+inline void ScalarDistances(T l, T a, T b, const T* cl, const T* ca,
+                            const T* cb, int begin, int end, T* distances) {
+  for (int i = begin; i < end; i++) {
+    T d_l = l - cl[i];
+    T d_a = a - ca[i];
+    T d_b = b - cb[i];
+    distances[i] = (d_l * d_l) + (d_a * d_a) + (d_b * d_b);
+  }
+}
+
+#ifdef MCU_HAS_X86_KERNELS
+
+__attribute__((target("sse4.2"))) void Sse42Distances(
+    double l, double a, double b, const double* cl, const double* ca,
+    const double* cb, int count, double* distances) {
+  __m128d point_l = _mm_set1_pd(l);
+  __m128d point_a = _mm_set1_pd(a);
+  __m128d point_b = _mm_set1_pd(b);
+  int i = 0;
+  for (; i + 2 <= count; i += 2) {
+    __m128d d_l = _mm_sub_pd(point_l, _mm_loadu_pd(cl + i));
+    __m128d d_a = _mm_sub_pd(point_a, _mm_loadu_pd(ca + i));
+    __m128d d_b = _mm_sub_pd(point_b, _mm_loadu_pd(cb + i));
+    __m128d sum = _mm_add_pd(_mm_mul_pd(d_l, d_l), _mm_mul_pd(d_a, d_a));
+    _mm_storeu_pd(distances + i, _mm_add_pd(sum, _mm_mul_pd(d_b, d_b)));
+  }
+  ScalarDistances(l, a, b, cl, ca, cb, i, count, distances);
+}
+
+__attribute__((target("sse4.2"))) void Sse42Distances(
+    float l, float a, float b, const float* cl, const float* ca,
+    const float* cb, int count, float* distances) {
+  __m128 point_l = _mm_set1_ps(l);
+  __m128 point_a = _mm_set1_ps(a);
+  __m128 point_b = _mm_set1_ps(b);
+  int i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m128 d_l = _mm_sub_ps(point_l, _mm_loadu_ps(cl + i));
+    __m128 d_a = _mm_sub_ps(point_a, _mm_loadu_ps(ca + i));
+    __m128 d_b = _mm_sub_ps(point_b, _mm_loadu_ps(cb + i));
+    __m128 sum = _mm_add_ps(_mm_mul_ps(d_l, d_l), _mm_mul_ps(d_a, d_a));
+    _mm_storeu_ps(distances + i, _mm_add_ps(sum, _mm_mul_ps(d_b, d_b)));
+  }
+  ScalarDistances(l, a, b, cl, ca, cb, i, count, distances);
+}
+
+__attribute__((target("avx2"))) void Avx2Distances(
+    double l, double a, double b, const double* cl, const double* ca,
+    const double* cb, int count, double* distances) {
+  __m256d point_l = _mm256_set1_pd(l);
+  __m256d point_a = _mm256_set1_pd(a);
+  __m256d point_b = _mm256_set1_pd(b);
+  int i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m256d d_l = _mm256_sub_pd(point_l, _mm256_loadu_pd(cl + i));
+    __m256d d_a = _mm256_sub_pd(point_a, _mm256_loadu_pd(ca + i));
+    __m256d d_b = _mm256_sub_pd(point_b, _mm256_loadu_pd(cb + i));
+    __m256d sum =
+        _mm256_add_pd(_mm256_mul_pd(d_l, d_l), _mm256_mul_pd(d_a, d_a));
+    _mm256_storeu_pd(distances + i,
+                     _mm256_add_pd(sum, _mm256_mul_pd(d_b, d_b)));
+  }
+  ScalarDistances(l, a, b, cl, ca, cb, i, count, distances);
+}
+
+__attribute__((target("avx2"))) void Avx2Distances(
+    float l, float a, float b, const float* cl, const float* ca,
+    const float* cb, int count, float* distances) {
+  __m256 point_l = _mm256_set1_ps(l);
+  __m256 point_a = _mm256_set1_ps(a);
+  __m256 point_b = _mm256_set1_ps(b);
+  int i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256 d_l = _mm256_sub_ps(point_l, _mm256_loadu_ps(cl + i));
+    __m256 d_a = _mm256_sub_ps(point_a, _mm256_loadu_ps(ca + i));
+    __m256 d_b = _mm256_sub_ps(point_b, _mm256_loadu_ps(cb + i));
+    __m256 sum =
+        _mm256_add_ps(_mm256_mul_ps(d_l, d_l), _mm256_mul_ps(d_a, d_a));
+    _mm256_storeu_ps(distances + i,
+                     _mm256_add_ps(sum, _mm256_mul_ps(d_b, d_b)));
+  }
+  ScalarDistances(l, a, b, cl, ca, cb, i, count, distances);
+}
+
+#endif  // MCU_HAS_X86_KERNELS
+
+template <typename P, typename T>
+void Distances(SimdLevel level, const BasicLab<P>& point,
+               const LabArrays<T>& colors, T* distances) {
+  T l = static_cast<T>(point.l);
+  T a = static_cast<T>(point.a);
+  T b = static_cast<T>(point.b);
+  int count = colors.size();
+  const T* cl = colors.l.data();
+  const T* ca = colors.a.data();
+  const T* cb = colors.b.data();
+  // Never dispatch above what the CPU supports, even if asked to.
+  if (level > BestSimdLevel()) {
+    level = BestSimdLevel();
+  }
+  switch (level) {
+#ifdef MCU_HAS_X86_KERNELS
+    case SimdLevel::kAvx2:
+      Avx2Distances(l, a, b, cl, ca, cb, count, distances);
+      return;
+    case SimdLevel::kSse42:
+      Sse42Distances(l, a, b, cl, ca, cb, count, distances);
+      return;
+#endif
+    default:
+      ScalarDistances(l, a, b, cl, ca, cb, 0, count, distances);
+      return;
+  }
+}
+
+}  // namespace
+
+void SquaredLabDistances(SimdLevel level, const Lab& point,
+                         const LabArrays<double>& colors, double* distances) {
+  Distances(level, point, colors, distances);
+}
+
+void SquaredLabDistances(SimdLevel level, const Lab& point,
+                         const LabArrays<float>& colors, float* distances) {
+  Distances(level, point, colors, distances);
+}
+
+void SquaredLabDistances(SimdLevel level, const LabFloat& point,
+                         const LabArrays<float>& colors, float* distances) {
+  Distances(level, point, colors, distances);
+}
+
+}  // namespace material_color_utilities
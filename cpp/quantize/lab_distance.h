@@ -0,0 +1,79 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CPP_QUANTIZE_LAB_DISTANCE_H_
+#define CPP_QUANTIZE_LAB_DISTANCE_H_
+
+#include <vector>
+
+#include "cpp/quantize/lab.h"
+#include "cpp/utils/simd.h"
+
+namespace material_color_utilities {
+
+/**
+ * Lab colors stored as a structure of arrays, so that the distance from one
+ * point to many colors can be computed several lanes at a time.
+ */
+template <typename T>
+struct LabArrays {
+  std::vector<T> l;
+  std::vector<T> a;
+  std::vector<T> b;
+
+  int size() const { return l.size(); }
+
+  void Resize(int count) {
+    l.resize(count);
+    a.resize(count);
+    b.resize(count);
+  }
+
+  template <typename U>
+  void Set(int index, const BasicLab<U>& lab) {
+    l[index] = static_cast<T>(lab.l);
+    a[index] = static_cast<T>(lab.a);
+    b[index] = static_cast<T>(lab.b);
+  }
+};
+
+/**
+ * Computes the squared Euclidean distance from `point` to every color in
+ * `colors`, writing `colors.size()` values to `distances`.
+ *
+ * Each distance is computed with the same operations, in the same order, as
+ * Lab::DeltaE, so the double-precision kernels return bit-identical results
+ * at every SimdLevel.
+ */
+void SquaredLabDistances(SimdLevel level, const Lab& point,
+                         const LabArrays<double>& colors, double* distances);
+
+/**
+ * Single-precision variant of SquaredLabDistances. Processes twice as many
+ * lanes per instruction; results are only as accurate as float32.
+ */
+void SquaredLabDistances(SimdLevel level, const Lab& point,
+                         const LabArrays<float>& colors, float* distances);
+
+/**
+ * Variant of SquaredLabDistances for a point held in single precision.
+ */
+void SquaredLabDistances(SimdLevel level, const LabFloat& point,
+                         const LabArrays<float>& colors, float* distances);
+
+}  // namespace material_color_utilities
+
+#endif  // CPP_QUANTIZE_LAB_DISTANCE_H_
@@ -0,0 +1,108 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpp/quantize/lab_distance.h"
+
+#include <cstdlib>
+#include <vector>
+
+#include "testing/base/public/gunit.h"
+#include "cpp/quantize/lab.h"
+
+namespace material_color_utilities {
+
+namespace {
+
+std::vector<Lab> RandomLabs(int count) {
+  srand(42688);
+  std::vector<Lab> labs;
+  for (int i = 0; i < count; i++) {
+    labs.push_back(LabFromInt(0xff000000 | (rand() & 0xffffff)));
+  }
+  return labs;
+}
+
+TEST(LabDistanceTest, BestSimdLevelIsStable) {
+  EXPECT_EQ(BestSimdLevel(), BestSimdLevel());
+}
+
+TEST(LabDistanceTest, DoubleKernelsMatchDeltaEExactly) {
+  // 131 is deliberately not a multiple of any vector width, to cover the
+  // scalar tail of each kernel.
+  std::vector<Lab> colors = RandomLabs(131);
+  LabArrays<double> arrays;
+  arrays.Resize(colors.size());
+  for (size_t i = 0; i < colors.size(); i++) {
+    arrays.Set(i, colors[i]);
+  }
+  std::vector<Lab> points = RandomLabs(17);
+  std::vector<double> distances(colors.size());
+  for (SimdLevel level :
+       {SimdLevel::kScalar, SimdLevel::kSse42, SimdLevel::kAvx2}) {
+    for (const Lab& point : points) {
+      SquaredLabDistances(level, point, arrays, distances.data());
+      for (size_t i = 0; i < colors.size(); i++) {
+        EXPECT_EQ(distances[i], point.DeltaE(colors[i]))
+            << SimdLevelName(level);
+      }
+    }
+  }
+}
+
+TEST(LabDistanceTest, FloatKernelsMatchDeltaEApproximately) {
+  std::vector<Lab> colors = RandomLabs(131);
+  LabArrays<float> arrays;
+  arrays.Resize(colors.size());
+  for (size_t i = 0; i < colors.size(); i++) {
+    arrays.Set(i, colors[i]);
+  }
+  std::vector<Lab> points = RandomLabs(17);
+  std::vector<float> distances(colors.size());
+  for (SimdLevel level :
+       {SimdLevel::kScalar, SimdLevel::kSse42, SimdLevel::kAvx2}) {
+    for (const Lab& point : points) {
+      SquaredLabDistances(level, point, arrays, distances.data());
+      for (size_t i = 0; i < colors.size(); i++) {
+        double expected = point.DeltaE(colors[i]);
+        EXPECT_NEAR(distances[i], expected, 1e-3 + expected * 1e-5)
+            << SimdLevelName(level);
+      }
+    }
+  }
+}
+
+TEST(LabDistanceTest, FloatPointsMatchRoundedDoublePoints) {
+  std::vector<Lab> colors = RandomLabs(131);
+  LabArrays<float> arrays;
+  arrays.Resize(colors.size());
+  for (size_t i = 0; i < colors.size(); i++) {
+    arrays.Set(i, colors[i]);
+  }
+  std::vector<float> expected(colors.size());
+  std::vector<float> distances(colors.size());
+  for (SimdLevel level :
+       {SimdLevel::kScalar, SimdLevel::kSse42, SimdLevel::kAvx2}) {
+    for (const Lab& point : RandomLabs(17)) {
+      SquaredLabDistances(level, point, arrays, expected.data());
+      SquaredLabDistances(level, LabCast<float>(point), arrays,
+                          distances.data());
+      EXPECT_EQ(distances, expected) << SimdLevelName(level);
+    }
+  }
+}
+
+}  // namespace
+}  // namespace material_color_utilities
@@ -0,0 +1,112 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpp/quantize/lab.h"
+
+#include <math.h>
+
+#include <vector>
+
+#include "testing/base/public/gunit.h"
+#include "cpp/utils/utils.h"
+
+namespace material_color_utilities {
+
+namespace {
+
+// LabFromInt as written before linearization used a table and cube roots
+// were computed iteratively.
+Lab ReferenceLabFromInt(const Argb argb) {
+  double red_l = Linearized(RedFromInt(argb));
+  double green_l = Linearized(GreenFromInt(argb));
+  double blue_l = Linearized(BlueFromInt(argb));
+  double xyz[3] = {
+      0.41233895 * red_l + 0.35762064 * green_l + 0.18051042 * blue_l,
+      0.2126 * red_l + 0.7152 * green_l + 0.0722 * blue_l,
+      0.01932141 * red_l + 0.11916382 * green_l + 0.95034478 * blue_l};
+  double f[3];
+  for (int i = 0; i < 3; i++) {
+    double normalized = xyz[i] / kWhitePointD65[i];
+    if (normalized > 216.0 / 24389.0) {
+      f[i] = pow(normalized, 1.0 / 3.0);
+    } else {
+      f[i] = (24389.0 / 27.0 * normalized + 16) / 116;
+    }
+  }
+  return {116.0 * f[1] - 16, 500.0 * (f[0] - f[1]), 200.0 * (f[1] - f[2])};
+}
+
+TEST(LabTest, LinearizedMatchesFormula) {
+  for (int component = 0; component <= 255; component++) {
+    double normalized = component / 255.0;
+    double expected = normalized <= 0.040449936
+                          ? normalized / 12.92 * 100.0
+                          : pow((normalized + 0.055) / 1.055, 2.4) * 100.0;
+    EXPECT_EQ(Linearized(component), expected) << component;
+  }
+}
+
+TEST(LabTest, LabFromIntIsCloseToReference) {
+  double max_error = 0.0;
+  // Every 7th color covers all values of each channel without taking long.
+  for (Argb rgb = 0; rgb <= 0xffffff; rgb += 7) {
+    Argb argb = 0xff000000 | rgb;
+    Lab expected = ReferenceLabFromInt(argb);
+    Lab actual = LabFromInt(argb);
+    max_error = fmax(max_error, fabs(actual.l - expected.l));
+    max_error = fmax(max_error, fabs(actual.a - expected.a));
+    max_error = fmax(max_error, fabs(actual.b - expected.b));
+  }
+  EXPECT_LE(max_error, 1e-10);
+}
+
+TEST(LabTest, LabFromIntsMatchesLabFromInt) {
+  // An odd count exercises both the vector loop and the remainder.
+  std::vector<Argb> argbs;
+  for (Argb rgb = 0; rgb <= 0xffffff; rgb += 4099) {
+    argbs.push_back(0xff000000 | rgb);
+  }
+  argbs.push_back(0xffffffff);
+  ASSERT_NE(argbs.size() % 4, 0);
+  std::vector<Lab> labs(argbs.size());
+  LabFromInts(argbs, absl::MakeSpan(labs));
+  for (size_t i = 0; i < argbs.size(); i++) {
+    Lab expected = LabFromInt(argbs[i]);
+    EXPECT_NEAR(labs[i].l, expected.l, 1e-12) << argbs[i];
+    EXPECT_NEAR(labs[i].a, expected.a, 1e-12) << argbs[i];
+    EXPECT_NEAR(labs[i].b, expected.b, 1e-12) << argbs[i];
+  }
+}
+
+TEST(LabTest, FloatLabFromIntsRoundsLabFromInt) {
+  std::vector<Argb> argbs;
+  for (Argb rgb = 0; rgb <= 0xffffff; rgb += 4099) {
+    argbs.push_back(0xff000000 | rgb);
+  }
+  std::vector<LabFloat> labs(argbs.size());
+  LabFromInts(argbs, absl::MakeSpan(labs));
+  for (size_t i = 0; i < argbs.size(); i++) {
+    Lab expected = LabFromInt(argbs[i]);
+    // Within one float rounding of the double result.
+    EXPECT_NEAR(labs[i].l, expected.l, 1e-5) << argbs[i];
+    EXPECT_NEAR(labs[i].a, expected.a, 1e-5) << argbs[i];
+    EXPECT_NEAR(labs[i].b, expected.b, 1e-5) << argbs[i];
+  }
+}
+
+}  // namespace
+
+}  // namespace material_color_utilities
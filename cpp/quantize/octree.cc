@@ -0,0 +1,214 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpp/quantize/octree.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "cpp/quantize/pixel_view.h"
+#include "cpp/quantize/wsmeans.h"
+#include "cpp/utils/utils.h"
+
+namespace material_color_utilities {
+
+namespace {
+
+// Leaves are 5 levels below the root, one per 5-bit-per-channel color cell.
+constexpr int kDepth = 5;
+
+/**
+ * Pixel counts and channel sums of every node at one depth of the octree.
+ * The node containing a color is indexed by the top `depth` bits of its red,
+ * green and blue channels, interleaved; its parent's index is its own
+ * shifted right by 3.
+ */
+struct OctreeLevel {
+  std::vector<uint64_t> counts;
+  std::vector<uint64_t> red_sums;
+  std::vector<uint64_t> green_sums;
+  std::vector<uint64_t> blue_sums;
+
+  explicit OctreeLevel(int depth)
+      : counts(1 << (3 * depth)),
+        red_sums(counts.size()),
+        green_sums(counts.size()),
+        blue_sums(counts.size()) {}
+
+  Argb MeanColor(int index) const {
+    uint64_t count = counts[index];
+    return ArgbFromRgb((red_sums[index] + count / 2) / count,
+                       (green_sums[index] + count / 2) / count,
+                       (blue_sums[index] + count / 2) / count);
+  }
+};
+
+int LeafIndex(Argb argb) {
+  int index = 0;
+  for (int bit = 7; bit > 7 - kDepth; bit--) {
+    index = (index << 3) | (((argb >> (16 + bit)) & 1) << 2) |
+            (((argb >> (8 + bit)) & 1) << 1) | ((argb >> bit) & 1);
+  }
+  return index;
+}
+
+}  // namespace
+
+QuantizerResult QuantizeOctree(const std::vector<Argb>& pixels,
+                               uint16_t max_colors) {
+  FlatQuantizerResult result;
+  QuantizeOctree(PixelView(pixels), max_colors, &result);
+  return ToQuantizerResult(result);
+}
+
+void QuantizeOctree(const PixelView& pixels, uint16_t max_colors,
+                    FlatQuantizerResult* result) {
+  result->Clear();
+  if (max_colors == 0 || pixels.pixel_count() == 0) {
+    return;
+  }
+  if (max_colors > 256) {
+    max_colors = 256;
+  }
+
+  // Counts pixels into the leaves, and marks each distinct color in a bitmap
+  // of every RGB value, which lists them in order without sorting.
+  std::vector<OctreeLevel> levels;
+  for (int depth = 0; depth <= kDepth; depth++) {
+    levels.emplace_back(depth);
+  }
+  OctreeLevel& leaves = levels[kDepth];
+  std::vector<uint64_t> seen_colors(1 << 18);
+  PixelView opaque_pixels = pixels;
+  opaque_pixels.opaque_only = true;
+  ForEachPixel(opaque_pixels, [&](Argb pixel) {
+    int leaf = LeafIndex(pixel);
+    leaves.counts[leaf]++;
+    leaves.red_sums[leaf] += RedFromInt(pixel);
+    leaves.green_sums[leaf] += GreenFromInt(pixel);
+    leaves.blue_sums[leaf] += BlueFromInt(pixel);
+    uint32_t rgb = pixel & 0x00ffffff;
+    seen_colors[rgb >> 6] |= uint64_t{1} << (rgb & 63);
+  });
+
+  int leaf_count = 0;
+  for (uint64_t count : leaves.counts) {
+    leaf_count += count != 0;
+  }
+  if (leaf_count == 0) {
+    return;
+  }
+
+  for (int depth = kDepth - 1; depth >= 0; depth--) {
+    OctreeLevel& level = levels[depth];
+    const OctreeLevel& children = levels[depth + 1];
+    for (size_t i = 0; i < children.counts.size(); i++) {
+      level.counts[i >> 3] += children.counts[i];
+      level.red_sums[i >> 3] += children.red_sums[i];
+      level.green_sums[i >> 3] += children.green_sums[i];
+      level.blue_sums[i >> 3] += children.blue_sums[i];
+    }
+  }
+
+  // Merges nodes into leaves, deepest level first and least populated node
+  // first, until few enough leaves remain. A level is only reached once
+  // every node below it has been merged, so all of a node's children are
+  // leaves when it is.
+  std::vector<std::vector<char>> merged(kDepth);
+  std::vector<std::pair<uint64_t, int>> candidates;
+  for (int depth = kDepth - 1; depth >= 0 && leaf_count > max_colors;
+       depth--) {
+    const OctreeLevel& level = levels[depth];
+    const OctreeLevel& children = levels[depth + 1];
+    merged[depth].assign(level.counts.size(), false);
+    candidates.clear();
+    for (size_t i = 0; i < level.counts.size(); i++) {
+      if (level.counts[i] != 0) {
+        candidates.push_back({level.counts[i], i});
+      }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    for (const auto& [count, index] : candidates) {
+      int child_count = 0;
+      for (int child = index << 3; child < (index + 1) << 3; child++) {
+        child_count += children.counts[child] != 0;
+      }
+      merged[depth][index] = true;
+      leaf_count -= child_count - 1;
+      if (leaf_count <= max_colors) {
+        break;
+      }
+    }
+  }
+
+  // Finds the leaf each nonempty cell ended up in: its shallowest merged
+  // ancestor, or itself.
+  std::vector<std::vector<int>> leaf_slots(kDepth + 1);
+  for (int depth = 0; depth <= kDepth; depth++) {
+    leaf_slots[depth].assign(levels[depth].counts.size(), -1);
+  }
+  std::vector<int> cell_slots(leaves.counts.size(), -1);
+  std::vector<Argb> leaf_colors;
+  std::vector<uint64_t> leaf_populations;
+  for (size_t cell = 0; cell < leaves.counts.size(); cell++) {
+    if (leaves.counts[cell] == 0) {
+      continue;
+    }
+    int depth = 0;
+    int index = 0;
+    while (depth < kDepth &&
+           (merged[depth].empty() || !merged[depth][index])) {
+      depth++;
+      index = cell >> (3 * (kDepth - depth));
+    }
+    int& slot = leaf_slots[depth][index];
+    if (slot == -1) {
+      slot = leaf_colors.size();
+      leaf_colors.push_back(levels[depth].MeanColor(index));
+      leaf_populations.push_back(levels[depth].counts[index]);
+    }
+    cell_slots[cell] = slot;
+  }
+
+  // Different leaves can average to the same color; they share one palette
+  // entry.
+  std::vector<Argb>& colors = result->colors;
+  colors = leaf_colors;
+  std::sort(colors.begin(), colors.end());
+  colors.erase(std::unique(colors.begin(), colors.end()), colors.end());
+  result->populations.assign(colors.size(), 0);
+  std::vector<uint8_t> slot_palette_indices(leaf_colors.size());
+  for (size_t i = 0; i < leaf_colors.size(); i++) {
+    int palette_index =
+        std::lower_bound(colors.begin(), colors.end(), leaf_colors[i]) -
+        colors.begin();
+    slot_palette_indices[i] = palette_index;
+    result->populations[palette_index] += leaf_populations[i];
+  }
+
+  for (size_t word = 0; word < seen_colors.size(); word++) {
+    for (uint64_t bits = seen_colors[word]; bits != 0; bits &= bits - 1) {
+      Argb argb = 0xff000000 | (word << 6) | __builtin_ctzll(bits);
+      result->input_pixels.push_back(argb);
+      result->cluster_indices.push_back(
+          slot_palette_indices[cell_slots[LeafIndex(argb)]]);
+    }
+  }
+}
+
+}  // namespace material_color_utilities
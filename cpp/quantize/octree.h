@@ -0,0 +1,56 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CPP_QUANTIZE_OCTREE_H_
+#define CPP_QUANTIZE_OCTREE_H_
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "cpp/quantize/pixel_view.h"
+#include "cpp/quantize/wsmeans.h"
+#include "cpp/utils/utils.h"
+
+namespace material_color_utilities {
+
+/**
+ * Quantizes pixels with an octree, in a single pass over the image and no
+ * iteration: pixels are counted into the leaves of an octree 5 levels deep,
+ * then the least populated nodes of the deepest level are merged into their
+ * parents until at most `max_colors` leaves remain. Each palette color is
+ * the mean of the pixels in its leaf.
+ *
+ * Much faster than QuantizeCelebi, at the cost of palettes that follow the
+ * octree's fixed cell boundaries rather than the image's clusters. Like
+ * QuantizeCelebi, transparent pixels are skipped.
+ *
+ * @param max_colors 1 <= max_colors <= 256.
+ */
+QuantizerResult QuantizeOctree(const std::vector<Argb>& pixels,
+                               uint16_t max_colors);
+
+/**
+ * Variant of QuantizeOctree that reads pixels in place from a caller-owned
+ * image and writes its result to sorted arrays, reusing the storage already
+ * held by `result`.
+ */
+void QuantizeOctree(const PixelView& pixels, uint16_t max_colors,
+                    FlatQuantizerResult* result);
+
+}  // namespace material_color_utilities
+
+#endif  // CPP_QUANTIZE_OCTREE_H_
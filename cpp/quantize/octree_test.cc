@@ -0,0 +1,111 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpp/quantize/octree.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "testing/base/public/gunit.h"
+#include "cpp/quantize/pixel_view.h"
+#include "cpp/quantize/synthetic_images.h"
+#include "cpp/quantize/wsmeans.h"
+
+namespace material_color_utilities {
+
+namespace {
+
+TEST(OctreeTest, Empty) {
+  QuantizerResult result = QuantizeOctree({}, 16);
+  EXPECT_TRUE(result.color_to_count.empty());
+  EXPECT_TRUE(result.input_pixel_to_cluster_pixel.empty());
+}
+
+TEST(OctreeTest, TwoRedThreeGreen) {
+  std::vector<Argb> pixels = {0xffff0000, 0xffff0000, 0xffff0000, 0xff00ff00,
+                              0xff00ff00};
+  QuantizerResult result = QuantizeOctree(pixels, 256);
+  ASSERT_EQ(result.color_to_count.size(), 2u);
+  EXPECT_EQ(result.color_to_count[0xffff0000], 3u);
+  EXPECT_EQ(result.color_to_count[0xff00ff00], 2u);
+}
+
+TEST(OctreeTest, OneColorPerCellIsExact) {
+  std::vector<Argb> pixels;
+  for (int i = 0; i < 32; i++) {
+    pixels.push_back(ArgbFromRgb(i * 8, 255 - i * 8, 128));
+  }
+  QuantizerResult result = QuantizeOctree(pixels, 256);
+  EXPECT_EQ(result.color_to_count.size(), 32u);
+  for (Argb pixel : pixels) {
+    EXPECT_EQ(result.input_pixel_to_cluster_pixel[pixel], pixel);
+  }
+}
+
+TEST(OctreeTest, SkipsTransparentPixels) {
+  std::vector<Argb> pixels = {0xff0000ff, 0x800000ff, 0x00ff0000};
+  QuantizerResult result = QuantizeOctree(pixels, 16);
+  ASSERT_EQ(result.color_to_count.size(), 1u);
+  EXPECT_EQ(result.color_to_count[0xff0000ff], 1u);
+  EXPECT_EQ(result.input_pixel_to_cluster_pixel.size(), 1u);
+}
+
+TEST(OctreeTest, SyntheticImages) {
+  for (const SyntheticImage& image : SyntheticImageCorpus(96, 64)) {
+    uint32_t opaque_count = 0;
+    for (Argb pixel : image.pixels) {
+      opaque_count += IsOpaque(pixel);
+    }
+    for (int max_colors : {1, 4, 16, 128, 256}) {
+      FlatQuantizerResult result;
+      QuantizeOctree(PixelView(image.pixels), max_colors, &result);
+      SCOPED_TRACE(image.name + " " + std::to_string(max_colors));
+      ASSERT_FALSE(result.colors.empty());
+      EXPECT_LE(result.colors.size(), static_cast<size_t>(max_colors));
+      EXPECT_TRUE(std::is_sorted(result.colors.begin(), result.colors.end()));
+      EXPECT_TRUE(std::is_sorted(result.input_pixels.begin(),
+                                 result.input_pixels.end()));
+      ASSERT_EQ(result.input_pixels.size(), result.cluster_indices.size());
+
+      // Every opaque pixel is counted once, in the cluster of its color.
+      uint32_t population_sum = 0;
+      for (uint32_t population : result.populations) {
+        EXPECT_GT(population, 0u);
+        population_sum += population;
+      }
+      EXPECT_EQ(population_sum, opaque_count);
+      for (uint8_t index : result.cluster_indices) {
+        EXPECT_LT(index, result.colors.size());
+      }
+    }
+  }
+}
+
+TEST(OctreeTest, FlatMatchesMap) {
+  std::vector<Argb> pixels = SyntheticImageCorpus(48, 48)[0].pixels;
+  FlatQuantizerResult flat;
+  QuantizeOctree(PixelView(pixels), 32, &flat);
+  QuantizerResult result = QuantizeOctree(pixels, 32);
+  QuantizerResult converted = ToQuantizerResult(flat);
+  EXPECT_EQ(result.color_to_count, converted.color_to_count);
+  EXPECT_EQ(result.input_pixel_to_cluster_pixel,
+            converted.input_pixel_to_cluster_pixel);
+}
+
+}  // namespace
+}  // namespace material_color_utilities
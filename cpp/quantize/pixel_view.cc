@@ -0,0 +1,48 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpp/quantize/pixel_view.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "cpp/utils/utils.h"
+
+namespace material_color_utilities {
+
+Argb PixelView::At(size_t index) const {
+  size_t y = index / width;
+  size_t x = index % width;
+  const uint8_t* bytes = static_cast<const uint8_t*>(data) + y * stride + 4 * x;
+  switch (format) {
+    case PixelFormat::kRgba8888:
+      return DecodePixel<PixelFormat::kRgba8888>(bytes);
+    case PixelFormat::kBgra8888:
+      return DecodePixel<PixelFormat::kBgra8888>(bytes);
+    default:
+      return DecodePixel<PixelFormat::kArgb>(bytes);
+  }
+}
+
+PixelView PixelView::Crop(int x, int y, int width, int height) const {
+  PixelView crop = *this;
+  crop.data = static_cast<const uint8_t*>(data) + y * stride + 4 * x;
+  crop.width = width;
+  crop.height = height;
+  return crop;
+}
+
+}  // namespace material_color_utilities
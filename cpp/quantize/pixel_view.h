@@ -0,0 +1,157 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CPP_QUANTIZE_PIXEL_VIEW_H_
+#define CPP_QUANTIZE_PIXEL_VIEW_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cstring>
+
+#include "absl/types/span.h"
+#include "cpp/utils/utils.h"
+
+namespace material_color_utilities {
+
+/**
+ * Memory layout of one pixel.
+ * `kArgb`: a 32-bit Argb value in native byte order, as used throughout
+ *          this library.
+ * `kRgba8888`: four bytes: red, green, blue, alpha.
+ * `kBgra8888`: four bytes: blue, green, red, alpha.
+ */
+enum class PixelFormat {
+  kArgb,
+  kRgba8888,
+  kBgra8888,
+};
+
+/**
+ * A read-only view of an image owned by the caller, which quantizers read in
+ * place instead of requiring a copy repacked as Argb.
+ * `data`: the first byte of the first row.
+ * `width`, `height`: size of the image in pixels.
+ * `stride`: bytes from the start of one row to the start of the next; at
+ *           least 4 * width.
+ * `format`: layout of each pixel.
+ * `opaque_only`: if true, pixels that are not fully opaque are skipped, as
+ *                if they were not part of the image.
+ *
+ * Pixels are visited row by row, left to right.
+ */
+struct PixelView {
+  const void* data = nullptr;
+  int width = 0;
+  int height = 0;
+  size_t stride = 0;
+  PixelFormat format = PixelFormat::kArgb;
+  bool opaque_only = false;
+
+  PixelView() = default;
+
+  PixelView(const void* data, int width, int height, size_t stride,
+            PixelFormat format)
+      : data(data),
+        width(width),
+        height(height),
+        stride(stride),
+        format(format) {}
+
+  /**
+   * Views Argb pixels as a single row.
+   */
+  explicit PixelView(absl::Span<const Argb> pixels)
+      : data(pixels.data()),
+        width(static_cast<int>(pixels.size())),
+        height(pixels.empty() ? 0 : 1),
+        stride(pixels.size() * sizeof(Argb)),
+        format(PixelFormat::kArgb) {}
+
+  /**
+   * Returns the number of pixels in the image, including any that
+   * `opaque_only` skips.
+   */
+  size_t pixel_count() const { return static_cast<size_t>(width) * height; }
+
+  /**
+   * Returns a view of the `width` x `height` rectangle whose top-left pixel
+   * is at column `x`, row `y`. The rectangle must lie within this view.
+   */
+  PixelView Crop(int x, int y, int width, int height) const;
+
+  /**
+   * Returns the pixel at `index`, counting row by row, left to right, whether
+   * or not it is opaque.
+   */
+  Argb At(size_t index) const;
+};
+
+template <PixelFormat kFormat>
+inline Argb DecodePixel(const uint8_t* bytes) {
+  switch (kFormat) {
+    case PixelFormat::kRgba8888:
+      return (static_cast<Argb>(bytes[3]) << 24) |
+             (static_cast<Argb>(bytes[0]) << 16) |
+             (static_cast<Argb>(bytes[1]) << 8) | bytes[2];
+    case PixelFormat::kBgra8888:
+      return (static_cast<Argb>(bytes[3]) << 24) |
+             (static_cast<Argb>(bytes[2]) << 16) |
+             (static_cast<Argb>(bytes[1]) << 8) | bytes[0];
+    default: {
+      Argb argb;
+      memcpy(&argb, bytes, sizeof(argb));
+      return argb;
+    }
+  }
+}
+
+template <PixelFormat kFormat, typename Visitor>
+void ForEachPixelInFormat(const PixelView& view, Visitor& visit) {
+  const uint8_t* row = static_cast<const uint8_t*>(view.data);
+  for (int y = 0; y < view.height; y++, row += view.stride) {
+    for (int x = 0; x < view.width; x++) {
+      Argb pixel = DecodePixel<kFormat>(row + 4 * x);
+      if (view.opaque_only && (pixel >> 24) != 0xff) {
+        continue;
+      }
+      visit(pixel);
+    }
+  }
+}
+
+/**
+ * Calls `visit(Argb)` with every pixel of `view`, in order, decoding each
+ * as it is read. The format is dispatched once, not per pixel.
+ */
+template <typename Visitor>
+void ForEachPixel(const PixelView& view, Visitor&& visit) {
+  switch (view.format) {
+    case PixelFormat::kRgba8888:
+      ForEachPixelInFormat<PixelFormat::kRgba8888>(view, visit);
+      return;
+    case PixelFormat::kBgra8888:
+      ForEachPixelInFormat<PixelFormat::kBgra8888>(view, visit);
+      return;
+    default:
+      ForEachPixelInFormat<PixelFormat::kArgb>(view, visit);
+      return;
+  }
+}
+
+}  // namespace material_color_utilities
+
+#endif  // CPP_QUANTIZE_PIXEL_VIEW_H_
@@ -0,0 +1,99 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpp/quantize/pixel_view.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "testing/base/public/gunit.h"
+#include "cpp/utils/utils.h"
+
+namespace material_color_utilities {
+
+namespace {
+
+std::vector<Argb> VisitAll(const PixelView& view) {
+  std::vector<Argb> visited;
+  ForEachPixel(view, [&](Argb pixel) { visited.push_back(pixel); });
+  return visited;
+}
+
+TEST(PixelViewTest, DecodesRgba) {
+  // Two rows of two pixels, each row padded to 12 bytes.
+  std::vector<uint8_t> bytes = {
+      0x11, 0x22, 0x33, 0xff, 0x44, 0x55, 0x66, 0x80, 0, 0, 0, 0,  //
+      0x77, 0x88, 0x99, 0xff, 0xaa, 0xbb, 0xcc, 0xff, 0, 0, 0, 0,
+  };
+  PixelView view(bytes.data(), 2, 2, 12, PixelFormat::kRgba8888);
+  EXPECT_EQ(view.pixel_count(), 4u);
+  EXPECT_EQ(VisitAll(view), std::vector<Argb>({0xff112233, 0x80445566,
+                                               0xff778899, 0xffaabbcc}));
+  EXPECT_EQ(view.At(1), 0x80445566u);
+  EXPECT_EQ(view.At(2), 0xff778899u);
+}
+
+TEST(PixelViewTest, DecodesBgra) {
+  std::vector<uint8_t> bytes = {0x33, 0x22, 0x11, 0xff, 0x66, 0x55, 0x44, 0x00};
+  PixelView view(bytes.data(), 2, 1, 8, PixelFormat::kBgra8888);
+  EXPECT_EQ(VisitAll(view), std::vector<Argb>({0xff112233, 0x00445566}));
+}
+
+TEST(PixelViewTest, ViewsArgbVector) {
+  std::vector<Argb> pixels = {0xff010203, 0x7f040506, 0xff070809};
+  PixelView view(pixels);
+  EXPECT_EQ(view.width, 3);
+  EXPECT_EQ(view.height, 1);
+  EXPECT_EQ(VisitAll(view), pixels);
+  EXPECT_EQ(view.At(2), 0xff070809u);
+}
+
+TEST(PixelViewTest, OpaqueOnlySkipsTranslucentPixels) {
+  std::vector<Argb> pixels = {0xff010203, 0x7f040506, 0x00000000, 0xff070809};
+  PixelView view(pixels);
+  view.opaque_only = true;
+  EXPECT_EQ(VisitAll(view), std::vector<Argb>({0xff010203, 0xff070809}));
+  // The image itself still includes every pixel.
+  EXPECT_EQ(view.pixel_count(), 4u);
+  EXPECT_EQ(view.At(1), 0x7f040506u);
+}
+
+TEST(PixelViewTest, CropKeepsStrideAndFormat) {
+  // Two rows of three pixels, each row padded to 16 bytes.
+  std::vector<uint8_t> bytes = {
+      0x11, 0x22, 0x33, 0xff, 0x44, 0x55, 0x66, 0x80,
+      0x77, 0x88, 0x99, 0xff, 0,    0,    0,    0,  //
+      0xaa, 0xbb, 0xcc, 0xff, 0xdd, 0xee, 0xf0, 0xff,
+      0x01, 0x02, 0x03, 0x40, 0,    0,    0,    0,
+  };
+  PixelView view(bytes.data(), 3, 2, 16, PixelFormat::kRgba8888);
+  view.opaque_only = true;
+  PixelView crop = view.Crop(1, 0, 2, 2);
+  EXPECT_EQ(crop.pixel_count(), 4u);
+  EXPECT_EQ(crop.stride, 16u);
+  EXPECT_EQ(VisitAll(crop), std::vector<Argb>({0xff778899, 0xffddeef0}));
+  EXPECT_EQ(VisitAll(view.Crop(0, 1, 3, 1)),
+            std::vector<Argb>({0xffaabbcc, 0xffddeef0}));
+}
+
+TEST(PixelViewTest, Empty) {
+  std::vector<Argb> pixels;
+  EXPECT_EQ(PixelView(pixels).pixel_count(), 0u);
+  EXPECT_TRUE(VisitAll(PixelView(pixels)).empty());
+}
+
+}  // namespace
+}  // namespace material_color_utilities
@@ -0,0 +1,57 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpp/quantize/quantizer.h"
+
+#include <vector>
+
+#include "cpp/quantize/celebi.h"
+#include "cpp/quantize/octree.h"
+#include "cpp/quantize/pixel_view.h"
+#include "cpp/quantize/wsmeans.h"
+#include "cpp/utils/utils.h"
+
+namespace material_color_utilities {
+
+QuantizerResult Quantize(QuantizerKind kind, const std::vector<Argb>& pixels,
+                         uint16_t max_colors) {
+  FlatQuantizerResult result;
+  Quantize(kind, PixelView(pixels), max_colors, &result);
+  return ToQuantizerResult(result);
+}
+
+void Quantize(QuantizerKind kind, const PixelView& pixels,
+              uint16_t max_colors, FlatQuantizerResult* result) {
+  switch (kind) {
+    case QuantizerKind::kCelebi:
+      QuantizeCelebi(pixels, max_colors, CelebiOptions(), result);
+      return;
+    case QuantizerKind::kWsmeans: {
+      // QuantizeWsmeans clusters every pixel it is given, so skip transparent
+      // ones here as the other kinds do.
+      PixelView opaque_pixels = pixels;
+      opaque_pixels.opaque_only = true;
+      QuantizeWsmeans(opaque_pixels, std::vector<Argb>(), max_colors,
+                      WsmeansOptions(), result);
+      return;
+    }
+    case QuantizerKind::kOctree:
+      QuantizeOctree(pixels, max_colors, result);
+      return;
+  }
+}
+
+}  // namespace material_color_utilities
@@ -0,0 +1,62 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CPP_QUANTIZE_QUANTIZER_H_
+#define CPP_QUANTIZE_QUANTIZER_H_
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "cpp/quantize/pixel_view.h"
+#include "cpp/quantize/wsmeans.h"
+#include "cpp/utils/utils.h"
+
+namespace material_color_utilities {
+
+/**
+ * The quantizers that produce a QuantizerResult, from slowest and closest
+ * to the image's clusters to fastest.
+ * `kCelebi`: QuantizeCelebi; Wu's palette refined by WSMeans.
+ * `kWsmeans`: QuantizeWsmeans from random starting clusters.
+ * `kOctree`: QuantizeOctree; a single pass, for latency-critical callers.
+ */
+enum class QuantizerKind {
+  kCelebi,
+  kWsmeans,
+  kOctree,
+};
+
+/**
+ * Quantizes pixels with the quantizer `kind` names, with its default
+ * options. Every kind skips transparent pixels.
+ *
+ * @param max_colors 1 <= max_colors <= 256.
+ */
+QuantizerResult Quantize(QuantizerKind kind, const std::vector<Argb>& pixels,
+                         uint16_t max_colors);
+
+/**
+ * Variant of Quantize that reads pixels in place from a caller-owned image
+ * and writes its result to sorted arrays, reusing the storage already held
+ * by `result`.
+ */
+void Quantize(QuantizerKind kind, const PixelView& pixels,
+              uint16_t max_colors, FlatQuantizerResult* result);
+
+}  // namespace material_color_utilities
+
+#endif  // CPP_QUANTIZE_QUANTIZER_H_
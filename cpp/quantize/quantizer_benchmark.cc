@@ -0,0 +1,110 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "testing/base/public/benchmark.h"
+#include "cpp/cam/hct.h"
+#include "cpp/quantize/lab.h"
+#include "cpp/quantize/pixel_view.h"
+#include "cpp/quantize/quantizer.h"
+#include "cpp/quantize/synthetic_images.h"
+#include "cpp/quantize/wsmeans.h"
+#include "cpp/score/score.h"
+#include "cpp/utils/utils.h"
+
+namespace material_color_utilities {
+
+namespace {
+
+constexpr int kImageSize = 512;
+
+const std::vector<SyntheticImage>& Corpus() {
+  static const std::vector<SyntheticImage>* corpus =
+      new std::vector<SyntheticImage>(
+          SyntheticImageCorpus(kImageSize, kImageSize));
+  return *corpus;
+}
+
+/**
+ * Returns the mean Lab distance from each color of `reference` to the
+ * nearest color of `palette`, weighted by the reference's populations.
+ */
+double PaletteDistance(const FlatQuantizerResult& reference,
+                       const FlatQuantizerResult& palette) {
+  double distance_sum = 0.0;
+  double population_sum = 0.0;
+  for (size_t i = 0; i < reference.colors.size(); i++) {
+    Lab lab = LabFromInt(reference.colors[i]);
+    double nearest = 1e9;
+    for (Argb color : palette.colors) {
+      nearest = std::min(nearest, lab.DeltaE(LabFromInt(color)));
+    }
+    distance_sum += std::sqrt(nearest) * reference.populations[i];
+    population_sum += reference.populations[i];
+  }
+  return population_sum == 0.0 ? 0.0 : distance_sum / population_sum;
+}
+
+// Argument: QuantizerKind.
+//
+// Besides timing, reports how far each quantizer's result is from
+// QuantizeCelebi's over the corpus:
+// `palette_distance`: mean distance in Lab from each Celebi palette color to
+//                     the nearest color of this palette, weighted by
+//                     population.
+// `top_hue_drift`: mean hue difference of the top suggestion, in degrees.
+// `top_match`: fraction of images whose top suggestion is unchanged.
+void BM_Quantize(benchmark::State& state) {
+  QuantizerKind kind = static_cast<QuantizerKind>(state.range(0));
+  FlatQuantizerResult result;
+  for (auto s : state) {
+    for (const SyntheticImage& image : Corpus()) {
+      Quantize(kind, PixelView(image.pixels), 128, &result);
+      benchmark::DoNotOptimize(result.colors.data());
+    }
+  }
+
+  double distance_sum = 0.0;
+  double drift_sum = 0.0;
+  int matches = 0;
+  for (const SyntheticImage& image : Corpus()) {
+    FlatQuantizerResult celebi;
+    Quantize(QuantizerKind::kCelebi, PixelView(image.pixels), 128, &celebi);
+    Quantize(kind, PixelView(image.pixels), 128, &result);
+    distance_sum += PaletteDistance(celebi, result);
+    Argb celebi_top = RankedSuggestions(celebi.colors, celebi.populations)[0];
+    Argb top = RankedSuggestions(result.colors, result.populations)[0];
+    drift_sum += DiffDegrees(Hct(celebi_top).get_hue(), Hct(top).get_hue());
+    matches += celebi_top == top;
+  }
+  state.counters["palette_distance"] = distance_sum / Corpus().size();
+  state.counters["top_hue_drift"] = drift_sum / Corpus().size();
+  state.counters["top_match"] = static_cast<double>(matches) / Corpus().size();
+  state.SetLabel(kind == QuantizerKind::kCelebi    ? "celebi"
+                 : kind == QuantizerKind::kWsmeans ? "wsmeans"
+                                                   : "octree");
+}
+BENCHMARK(BM_Quantize)
+    ->Arg(static_cast<int>(QuantizerKind::kCelebi))
+    ->Arg(static_cast<int>(QuantizerKind::kWsmeans))
+    ->Arg(static_cast<int>(QuantizerKind::kOctree))
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace material_color_utilities
@@ -0,0 +1,71 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpp/quantize/quantizer_session.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+#include "absl/types/span.h"
+#include "cpp/quantize/celebi.h"
+#include "cpp/quantize/pixel_view.h"
+#include "cpp/quantize/wsmeans.h"
+#include "cpp/utils/parallel.h"
+
+namespace material_color_utilities {
+
+QuantizerSession::QuantizerSession(const QuantizerSessionOptions& options)
+    : options_(options), workspaces_(std::max(1, options.num_threads)) {}
+
+std::chrono::nanoseconds QuantizerSession::Quantize(
+    const PixelView& image, FlatQuantizerResult* result) {
+  auto start = std::chrono::steady_clock::now();
+  QuantizeCelebi(image, options_.max_colors, options_.celebi, result,
+                 &workspaces_[0]);
+  return std::chrono::steady_clock::now() - start;
+}
+
+QuantizerBatchTimings QuantizerSession::QuantizeBatch(
+    absl::Span<const PixelView> images,
+    std::vector<FlatQuantizerResult>* results) {
+  QuantizerBatchTimings timings;
+  timings.per_image.resize(images.size());
+  results->resize(images.size());
+  auto start = std::chrono::steady_clock::now();
+
+  int image_count = images.size();
+  int worker_count = std::min<int>(workspaces_.size(), image_count);
+  std::atomic<int> next_image(0);
+  ParallelFor(worker_count, worker_count, [&](int worker) {
+    CelebiWorkspace* workspace = &workspaces_[worker];
+    for (int i = next_image++; i < image_count; i = next_image++) {
+      auto image_start = std::chrono::steady_clock::now();
+      QuantizeCelebi(images[i], options_.max_colors, options_.celebi,
+                     &(*results)[i], workspace);
+      timings.per_image[i] = std::chrono::steady_clock::now() - image_start;
+    }
+  });
+
+  timings.wall = std::chrono::steady_clock::now() - start;
+  for (std::chrono::nanoseconds image_time : timings.per_image) {
+    timings.busy += image_time;
+  }
+  return timings;
+}
+
+}  // namespace material_color_utilities
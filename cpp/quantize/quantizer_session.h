@@ -0,0 +1,99 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CPP_QUANTIZE_QUANTIZER_SESSION_H_
+#define CPP_QUANTIZE_QUANTIZER_SESSION_H_
+
+#include <stdint.h>
+
+#include <chrono>
+#include <vector>
+
+#include "absl/types/span.h"
+#include "cpp/quantize/celebi.h"
+#include "cpp/quantize/pixel_view.h"
+#include "cpp/quantize/wsmeans.h"
+
+namespace material_color_utilities {
+
+/**
+ * Options for QuantizerSession.
+ * `max_colors`: passed to QuantizeCelebi for every image.
+ * `celebi`: passed to QuantizeCelebi for every image.
+ * `num_threads`: maximum number of threads QuantizeBatch spreads images
+ *                across. Each thread keeps its own workspace.
+ */
+struct QuantizerSessionOptions {
+  uint16_t max_colors = 128;
+  CelebiOptions celebi;
+  int num_threads = 1;
+};
+
+/**
+ * Time taken by QuantizerSession::QuantizeBatch.
+ * `per_image`: time spent quantizing each image, in the order of the batch.
+ * `busy`: sum of `per_image`.
+ * `wall`: time from the start of the batch to the end.
+ */
+struct QuantizerBatchTimings {
+  std::vector<std::chrono::nanoseconds> per_image;
+  std::chrono::nanoseconds busy{0};
+  std::chrono::nanoseconds wall{0};
+};
+
+/**
+ * Quantizes many images with QuantizeCelebi, keeping the histogram, color
+ * table, clustering buffers and results' storage between images, so that
+ * after the first few images quantizing allocates next to nothing.
+ *
+ * Results are identical to calling QuantizeCelebi on each image.
+ *
+ * A session must not be used by two threads at once; QuantizeBatch spreads
+ * its own work across threads.
+ */
+class QuantizerSession {
+ public:
+  explicit QuantizerSession(const QuantizerSessionOptions& options = {});
+
+  /**
+   * Quantizes one image.
+   *
+   * @return the time taken.
+   */
+  std::chrono::nanoseconds Quantize(const PixelView& image,
+                                    FlatQuantizerResult* result);
+
+  /**
+   * Quantizes every image in `images`. Images are handed out to threads one
+   * at a time as threads become free, so a few large images do not hold up
+   * the rest.
+   *
+   * @param results Resized to the number of images; entries already present
+   *                are reused.
+   */
+  QuantizerBatchTimings QuantizeBatch(
+      absl::Span<const PixelView> images,
+      std::vector<FlatQuantizerResult>* results);
+
+ private:
+  QuantizerSessionOptions options_;
+  // One per thread; the first is also used by Quantize.
+  std::vector<CelebiWorkspace> workspaces_;
+};
+
+}  // namespace material_color_utilities
+
+#endif  // CPP_QUANTIZE_QUANTIZER_SESSION_H_
@@ -0,0 +1,125 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include "testing/base/public/benchmark.h"
+#include "cpp/quantize/celebi.h"
+#include "cpp/quantize/pixel_view.h"
+#include "cpp/quantize/quantizer_session.h"
+#include "cpp/quantize/synthetic_images.h"
+#include "cpp/quantize/wsmeans.h"
+
+// Counts every heap allocation in the process, so the benchmarks can report
+// how many allocations each image costs. The replacements are kept out of
+// line; once inlined, GCC pairs malloc() with operator delete, or operator
+// new with free(), and warns of a mismatch.
+namespace {
+std::atomic<int64_t> allocation_count(0);
+}  // namespace
+
+__attribute__((noinline)) void* operator new(size_t size) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  void* pointer = std::malloc(size == 0 ? 1 : size);
+  if (pointer == nullptr) {
+    throw std::bad_alloc();
+  }
+  return pointer;
+}
+
+__attribute__((noinline)) void operator delete(void* pointer) noexcept {
+  std::free(pointer);
+}
+
+__attribute__((noinline)) void operator delete(void* pointer,
+                                               size_t) noexcept {
+  std::free(pointer);
+}
+
+namespace material_color_utilities {
+
+namespace {
+
+constexpr int kImageSize = 256;
+
+const std::vector<SyntheticImage>& Corpus() {
+  static const std::vector<SyntheticImage>* corpus =
+      new std::vector<SyntheticImage>(
+          SyntheticImageCorpus(kImageSize, kImageSize));
+  return *corpus;
+}
+
+std::vector<PixelView> CorpusViews() {
+  std::vector<PixelView> views;
+  for (const SyntheticImage& image : Corpus()) {
+    views.push_back(PixelView(image.pixels));
+  }
+  return views;
+}
+
+void ReportAllocations(benchmark::State& state, int64_t allocations) {
+  state.counters["allocations_per_image"] =
+      static_cast<double>(allocations) /
+      (state.iterations() * Corpus().size());
+  state.SetItemsProcessed(state.iterations() * Corpus().size());
+}
+
+// The baseline: every image gets fresh buffers and a fresh result.
+void BM_QuantizeCelebiFresh(benchmark::State& state) {
+  std::vector<PixelView> images = CorpusViews();
+  int64_t allocations = 0;
+  for (auto s : state) {
+    int64_t before = allocation_count.load();
+    for (const PixelView& image : images) {
+      FlatQuantizerResult result;
+      QuantizeCelebi(image, 128, CelebiOptions(), &result);
+      benchmark::DoNotOptimize(result.colors.data());
+    }
+    allocations += allocation_count.load() - before;
+  }
+  ReportAllocations(state, allocations);
+}
+BENCHMARK(BM_QuantizeCelebiFresh)->Unit(benchmark::kMillisecond);
+
+// Argument: number of threads.
+void BM_QuantizerSessionBatch(benchmark::State& state) {
+  std::vector<PixelView> images = CorpusViews();
+  QuantizerSessionOptions options;
+  options.num_threads = state.range(0);
+  QuantizerSession session(options);
+  std::vector<FlatQuantizerResult> results;
+  // Warm the session up, as a long-running caller would have.
+  session.QuantizeBatch(images, &results);
+  int64_t allocations = 0;
+  for (auto s : state) {
+    int64_t before = allocation_count.load();
+    session.QuantizeBatch(images, &results);
+    allocations += allocation_count.load() - before;
+    benchmark::DoNotOptimize(results.data());
+  }
+  ReportAllocations(state, allocations);
+}
+BENCHMARK(BM_QuantizerSessionBatch)
+    ->Arg(1)
+    ->Arg(4)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace material_color_utilities
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpp/quantize/quantizer_session.h"
+
+#include <vector>
+
+#include "testing/base/public/gunit.h"
+#include "cpp/quantize/celebi.h"
+#include "cpp/quantize/pixel_view.h"
+#include "cpp/quantize/synthetic_images.h"
+#include "cpp/quantize/wsmeans.h"
+
+namespace material_color_utilities {
+
+namespace {
+
+void ExpectSameResult(const FlatQuantizerResult& actual,
+                      const FlatQuantizerResult& expected) {
+  EXPECT_EQ(actual.colors, expected.colors);
+  EXPECT_EQ(actual.populations, expected.populations);
+  EXPECT_EQ(actual.input_pixels, expected.input_pixels);
+  EXPECT_EQ(actual.cluster_indices, expected.cluster_indices);
+}
+
+TEST(QuantizerSessionTest, QuantizeMatchesCelebi) {
+  QuantizerSession session;
+  FlatQuantizerResult result;
+  // Images of different sizes, so reused buffers shrink as well as grow.
+  for (int size : {64, 16, 48}) {
+    for (const SyntheticImage& image : SyntheticImageCorpus(size, size)) {
+      FlatQuantizerResult expected;
+      QuantizeCelebi(image.pixels, 128, &expected);
+      session.Quantize(PixelView(image.pixels), &result);
+      ExpectSameResult(result, expected);
+    }
+  }
+}
+
+TEST(QuantizerSessionTest, BatchMatchesCelebi) {
+  std::vector<SyntheticImage> corpus = SyntheticImageCorpus(40, 30);
+  std::vector<SyntheticImage> small = SyntheticImageCorpus(8, 8);
+  corpus.insert(corpus.end(), small.begin(), small.end());
+  std::vector<PixelView> images;
+  for (const SyntheticImage& image : corpus) {
+    images.push_back(PixelView(image.pixels));
+  }
+
+  for (int num_threads : {1, 3}) {
+    QuantizerSessionOptions options;
+    options.max_colors = 16;
+    options.num_threads = num_threads;
+    QuantizerSession session(options);
+    std::vector<FlatQuantizerResult> results;
+    // Running twice checks that reused results are overwritten.
+    for (int round = 0; round < 2; round++) {
+      QuantizerBatchTimings timings = session.QuantizeBatch(images, &results);
+      ASSERT_EQ(results.size(), images.size());
+      ASSERT_EQ(timings.per_image.size(), images.size());
+      for (size_t i = 0; i < corpus.size(); i++) {
+        FlatQuantizerResult expected;
+        QuantizeCelebi(corpus[i].pixels, 16, &expected);
+        ExpectSameResult(results[i], expected);
+      }
+    }
+  }
+}
+
+TEST(QuantizerSessionTest, EmptyBatch) {
+  QuantizerSession session;
+  std::vector<FlatQuantizerResult> results(3);
+  QuantizerBatchTimings timings = session.QuantizeBatch({}, &results);
+  EXPECT_TRUE(results.empty());
+  EXPECT_TRUE(timings.per_image.empty());
+}
+
+}  // namespace
+}  // namespace material_color_utilities
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpp/quantize/quantizer.h"
+
+#include <vector>
+
+#include "testing/base/public/gunit.h"
+#include "cpp/quantize/celebi.h"
+#include "cpp/quantize/octree.h"
+#include "cpp/quantize/synthetic_images.h"
+#include "cpp/quantize/wsmeans.h"
+
+namespace material_color_utilities {
+
+namespace {
+
+TEST(QuantizerTest, KindsMatchTheirQuantizers) {
+  std::vector<Argb> pixels = SyntheticImageCorpus(48, 48)[1].pixels;
+
+  QuantizerResult celebi = Quantize(QuantizerKind::kCelebi, pixels, 16);
+  EXPECT_EQ(celebi.color_to_count, QuantizeCelebi(pixels, 16).color_to_count);
+
+  QuantizerResult wsmeans = Quantize(QuantizerKind::kWsmeans, pixels, 16);
+  EXPECT_EQ(wsmeans.color_to_count,
+            QuantizeWsmeans(pixels, {}, 16).color_to_count);
+
+  QuantizerResult octree = Quantize(QuantizerKind::kOctree, pixels, 16);
+  EXPECT_EQ(octree.color_to_count, QuantizeOctree(pixels, 16).color_to_count);
+}
+
+TEST(QuantizerTest, AllKindsSkipTransparentPixels) {
+  std::vector<Argb> pixels = {0xff0000ff, 0xff0000ff, 0x80ff0000,
+                              0x0000ff00, 0x00000000};
+  for (QuantizerKind kind : {QuantizerKind::kCelebi, QuantizerKind::kWsmeans,
+                             QuantizerKind::kOctree}) {
+    QuantizerResult result = Quantize(kind, pixels, 16);
+    ASSERT_EQ(result.color_to_count.size(), 1u);
+    EXPECT_EQ(result.color_to_count[0xff0000ff], 2u);
+    EXPECT_EQ(result.input_pixel_to_cluster_pixel.size(), 1u);
+  }
+}
+
+}  // namespace
+}  // namespace material_color_utilities
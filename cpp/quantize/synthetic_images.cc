@@ -0,0 +1,153 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpp/quantize/synthetic_images.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "cpp/utils/utils.h"
+
+namespace material_color_utilities {
+
+namespace {
+
+/**
+ * Small deterministic noise source; xorshift32.
+ */
+class Noise {
+ public:
+  explicit Noise(uint32_t seed) : state_(seed) {}
+
+  /**
+   * Returns an integer in [-amplitude, amplitude].
+   */
+  int Next(int amplitude) {
+    return static_cast<int>(NextBits() % (2 * amplitude + 1)) - amplitude;
+  }
+
+  uint32_t NextBits() {
+    state_ ^= state_ << 13;
+    state_ ^= state_ >> 17;
+    state_ ^= state_ << 5;
+    return state_;
+  }
+
+ private:
+  uint32_t state_;
+};
+
+Argb Mix(Argb from, Argb to, double amount) {
+  return ArgbFromRgb(
+      RedFromInt(from) + (RedFromInt(to) - RedFromInt(from)) * amount,
+      GreenFromInt(from) + (GreenFromInt(to) - GreenFromInt(from)) * amount,
+      BlueFromInt(from) + (BlueFromInt(to) - BlueFromInt(from)) * amount);
+}
+
+Argb AddNoise(Argb argb, Noise& noise, int amplitude) {
+  int red = std::clamp(RedFromInt(argb) + noise.Next(amplitude), 0, 255);
+  int green = std::clamp(GreenFromInt(argb) + noise.Next(amplitude), 0, 255);
+  int blue = std::clamp(BlueFromInt(argb) + noise.Next(amplitude), 0, 255);
+  return ArgbFromRgb(red, green, blue);
+}
+
+bool InDisc(int x, int y, int center_x, int center_y, int radius) {
+  int dx = x - center_x;
+  int dy = y - center_y;
+  return dx * dx + dy * dy <= radius * radius;
+}
+
+SyntheticImage Generate(
+    const std::string& name, int width, int height, uint32_t seed,
+    const std::function<Argb(int x, int y, Noise& noise)>& pixel_at) {
+  SyntheticImage image = {name, width, height, {}};
+  image.pixels.reserve(width * height);
+  Noise noise(seed);
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      image.pixels.push_back(pixel_at(x, y, noise));
+    }
+  }
+  return image;
+}
+
+}  // namespace
+
+std::vector<SyntheticImage> SyntheticImageCorpus(int width, int height) {
+  std::vector<SyntheticImage> corpus;
+  corpus.push_back(Generate(
+      "landscape", width, height, 1, [&](int x, int y, Noise& noise) {
+        if (y < height * 2 / 3) {
+          double amount = static_cast<double>(y) / (height * 2 / 3);
+          return AddNoise(Mix(0xff1e4d9c, 0xffb8e2f2, amount), noise, 3);
+        }
+        return AddNoise(((x / 7 + y / 5) % 3 == 0) ? 0xff5a4a2a : 0xff3f7a2c,
+                        noise, 18);
+      }));
+  corpus.push_back(Generate(
+      "sunset", width, height, 2, [&](int x, int y, Noise& noise) {
+        double amount = static_cast<double>(y) / height;
+        Argb sky = amount < 0.5 ? Mix(0xff2a1450, 0xffc2457a, amount * 2)
+                                : Mix(0xffc2457a, 0xffffa040, amount * 2 - 1);
+        if (InDisc(x, y, width / 2, height * 3 / 4, height / 8)) {
+          sky = 0xffffe070;
+        }
+        return AddNoise(sky, noise, 4);
+      }));
+  corpus.push_back(Generate(
+      "portrait", width, height, 3, [&](int x, int y, Noise& noise) {
+        if (InDisc(x, y, width / 2, height / 2, std::min(width, height) / 3)) {
+          return AddNoise(0xffe0a888, noise, 10);
+        }
+        return AddNoise(0xff1f4a4f, noise, 6);
+      }));
+  corpus.push_back(Generate(
+      "flowers", width, height, 4, [&](int x, int y, Noise& noise) {
+        int cell = std::max(8, width / 12);
+        int cell_x = x / cell;
+        int cell_y = y / cell;
+        if (InDisc(x % cell, y % cell, cell / 2, cell / 2, cell / 4)) {
+          constexpr Argb kPetals[] = {0xffd8233a, 0xfff2c12e, 0xff7b3fa0};
+          return AddNoise(kPetals[(cell_x * 7 + cell_y * 3) % 3], noise, 12);
+        }
+        return AddNoise(0xff2f6b2a, noise, 20);
+      }));
+  corpus.push_back(Generate(
+      "gray_with_accent", width, height, 5, [&](int x, int y, Noise& noise) {
+        if (x > width * 3 / 4 && y > height * 3 / 4) {
+          return AddNoise(0xffc8102e, noise, 6);
+        }
+        int gray = 60 + 120 * x / width;
+        return AddNoise(ArgbFromRgb(gray, gray, gray), noise, 8);
+      }));
+  corpus.push_back(Generate("noise", width, height, 6,
+                            [&](int, int, Noise& noise) {
+                              return 0xff000000 | (noise.NextBits() & 0xffffff);
+                            }));
+  corpus.push_back(Generate(
+      "sticker", width, height, 7, [&](int x, int y, Noise& noise) {
+        if (!InDisc(x, y, width / 2, height / 2, std::min(width, height) / 3)) {
+          return static_cast<Argb>(0x00ffffff);
+        }
+        return AddNoise(x < width / 2 ? 0xff0b8a6f : 0xfff06d2f, noise, 5);
+      }));
+  return corpus;
+}
+
+}  // namespace material_color_utilities
@@ -0,0 +1,46 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CPP_QUANTIZE_SYNTHETIC_IMAGES_H_
+#define CPP_QUANTIZE_SYNTHETIC_IMAGES_H_
+
+#include <string>
+#include <vector>
+
+#include "cpp/utils/utils.h"
+
+namespace material_color_utilities {
+
+/**
+ * A generated image, standing in for a photograph in tests and benchmarks.
+ */
+struct SyntheticImage {
+  std::string name;
+  int width = 0;
+  int height = 0;
+  std::vector<Argb> pixels;
+};
+
+/**
+ * Returns a small corpus of deterministic, photo-like images of the given
+ * size: smooth gradients, textured regions, small saturated accents, a
+ * mostly grayscale scene, uniform noise, and a partly transparent sticker.
+ */
+std::vector<SyntheticImage> SyntheticImageCorpus(int width, int height);
+
+}  // namespace material_color_utilities
+
+#endif  // CPP_QUANTIZE_SYNTHETIC_IMAGES_H_
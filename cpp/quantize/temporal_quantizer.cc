@@ -0,0 +1,153 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpp/quantize/temporal_quantizer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include "absl/types/span.h"
+#include "cpp/quantize/celebi.h"
+#include "cpp/quantize/lab.h"
+#include "cpp/quantize/pixel_view.h"
+#include "cpp/quantize/wsmeans.h"
+
+namespace material_color_utilities {
+
+namespace {
+
+constexpr int kHistogramBins = 1 << 12;
+
+/**
+ * Counts the opaque pixels of `frame` into 4-bit-per-channel bins.
+ *
+ * @return the number of opaque pixels.
+ */
+uint64_t CountFrame(const PixelView& frame, std::vector<uint32_t>& histogram) {
+  histogram.assign(kHistogramBins, 0);
+  PixelView opaque = frame;
+  opaque.opaque_only = true;
+  uint64_t count = 0;
+  ForEachPixel(opaque, [&](Argb pixel) {
+    int bin = ((pixel >> 12) & 0xf00) | ((pixel >> 8) & 0xf0) |
+              ((pixel >> 4) & 0xf);
+    histogram[bin]++;
+    count++;
+  });
+  return count;
+}
+
+/**
+ * Returns the total variation distance between two histograms: half the sum
+ * of the absolute differences of their normalized bins.
+ */
+double HistogramDelta(const std::vector<uint32_t>& a, uint64_t a_count,
+                      const std::vector<uint32_t>& b, uint64_t b_count) {
+  if (a_count == 0 || b_count == 0) {
+    return a_count == b_count ? 0.0 : 1.0;
+  }
+  double a_scale = 1.0 / a_count;
+  double b_scale = 1.0 / b_count;
+  double sum = 0.0;
+  for (int i = 0; i < kHistogramBins; i++) {
+    sum += std::abs(a[i] * a_scale - b[i] * b_scale);
+  }
+  return sum / 2.0;
+}
+
+/**
+ * Returns the population-weighted mean Lab distance from each color of
+ * `result` to the nearest of `previous_colors`.
+ */
+double PaletteDrift(const std::vector<Argb>& previous_colors,
+                    const FlatQuantizerResult& result) {
+  if (previous_colors.empty() || result.colors.empty()) {
+    return 0.0;
+  }
+  std::vector<Lab> previous(previous_colors.size());
+  LabFromInts(previous_colors, absl::MakeSpan(previous));
+  double drift_sum = 0.0;
+  double population_sum = 0.0;
+  for (size_t i = 0; i < result.colors.size(); i++) {
+    Lab lab = LabFromInt(result.colors[i]);
+    double nearest = lab.DeltaE(previous[0]);
+    for (size_t j = 1; j < previous.size(); j++) {
+      nearest = std::min(nearest, lab.DeltaE(previous[j]));
+    }
+    drift_sum += std::sqrt(nearest) * result.populations[i];
+    population_sum += result.populations[i];
+  }
+  return population_sum == 0.0 ? 0.0 : drift_sum / population_sum;
+}
+
+}  // namespace
+
+TemporalQuantizer::TemporalQuantizer(const TemporalQuantizerOptions& options)
+    : options_(options) {}
+
+void TemporalQuantizer::Reset() {
+  has_reference_ = false;
+  reuse_palette_ = false;
+  result_.Clear();
+  previous_colors_.clear();
+}
+
+TemporalFrameStats TemporalQuantizer::QuantizeFrame(const PixelView& frame) {
+  auto start = std::chrono::steady_clock::now();
+  TemporalFrameStats stats;
+
+  uint64_t frame_count = CountFrame(frame, frame_histogram_);
+  if (has_reference_) {
+    stats.histogram_delta = HistogramDelta(
+        reference_histogram_, reference_count_, frame_histogram_, frame_count);
+  } else {
+    stats.histogram_delta = 1.0;
+  }
+
+  if (!has_reference_ || stats.histogram_delta >= options_.reuse_threshold) {
+    // WSMeans never adds clusters to those it starts from, so warm starts
+    // that keep dropping or merging clusters would shrink the palette frame
+    // after frame; start from Wu again after one does. A palette smaller
+    // than max_colors because Wu found fewer clusters in the image is kept.
+    stats.warm_started =
+        has_reference_ && !result_.colors.empty() && reuse_palette_;
+    previous_colors_.swap(result_.colors);
+    WsmeansStats wsmeans_stats;
+    QuantizeCelebi(frame,
+                   stats.warm_started ? previous_colors_ : std::vector<Argb>(),
+                   options_.max_colors, options_.celebi, &result_, &workspace_,
+                   &wsmeans_stats);
+    reuse_palette_ =
+        !stats.warm_started ||
+        static_cast<int>(result_.colors.size()) == wsmeans_stats.clusters;
+    if (has_reference_) {
+      stats.palette_drift = PaletteDrift(previous_colors_, result_);
+    }
+    stats.reclustered = true;
+    reference_histogram_.swap(frame_histogram_);
+    reference_count_ = frame_count;
+    has_reference_ = true;
+  }
+
+  stats.time = std::chrono::steady_clock::now() - start;
+  return stats;
+}
+
+}  // namespace material_color_utilities
@@ -0,0 +1,123 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CPP_QUANTIZE_TEMPORAL_QUANTIZER_H_
+#define CPP_QUANTIZE_TEMPORAL_QUANTIZER_H_
+
+#include <stdint.h>
+
+#include <chrono>
+#include <vector>
+
+#include "cpp/quantize/celebi.h"
+#include "cpp/quantize/pixel_view.h"
+#include "cpp/quantize/wsmeans.h"
+
+namespace material_color_utilities {
+
+/**
+ * Options for TemporalQuantizer.
+ * `max_colors`: passed to QuantizeCelebi for every frame.
+ * `celebi`: passed to QuantizeCelebi for every frame.
+ * `reuse_threshold`: frames whose histogram_delta is below this reuse the
+ *                    current palette without clustering. 0 clusters every
+ *                    frame.
+ */
+struct TemporalQuantizerOptions {
+  uint16_t max_colors = 128;
+  CelebiOptions celebi;
+  double reuse_threshold = 0.02;
+};
+
+/**
+ * What TemporalQuantizer::QuantizeFrame did with one frame.
+ * `reclustered`: false if the previous palette was kept as is.
+ * `warm_started`: true if clustering started from the previous palette
+ *                 rather than from Wu.
+ * `histogram_delta`: the fraction of the frame's opaque pixels that would
+ *                    have to change color, at 4 bits per channel, to turn
+ *                    the histogram of the frame last clustered into this
+ *                    frame's; from 0 (the same) to 1 (disjoint).
+ * `palette_drift`: the mean distance in Lab from each new palette color to
+ *                  the nearest previous one, weighted by population. 0 if
+ *                  the frame was not reclustered or is the first.
+ * `time`: time spent on the frame.
+ */
+struct TemporalFrameStats {
+  bool reclustered = false;
+  bool warm_started = false;
+  double histogram_delta = 0.0;
+  double palette_drift = 0.0;
+  std::chrono::nanoseconds time{0};
+};
+
+/**
+ * Quantizes a sequence of similar frames, such as video or an animated
+ * wallpaper, keeping state from one frame to the next:
+ *
+ * - A coarse histogram of the last frame clustered. Frames close enough to
+ *   it keep the current palette, skipping clustering. Since frames are
+ *   compared with the last frame clustered, not the previous one, slow
+ *   drift still adds up to a recluster.
+ * - The palette, from which WSMeans starts on the next frame clustered. It
+ *   is usually close, so WSMeans converges in few iterations, and colors
+ *   do not jump between frames the way independently seeded palettes can.
+ * - The buffers used to quantize, as in QuantizerSession.
+ *
+ * The first frame, and any frame after Reset(), gives the same result as
+ * QuantizeCelebi.
+ */
+class TemporalQuantizer {
+ public:
+  explicit TemporalQuantizer(const TemporalQuantizerOptions& options = {});
+
+  /**
+   * Updates result() for the next frame.
+   */
+  TemporalFrameStats QuantizeFrame(const PixelView& frame);
+
+  /**
+   * The palette of the latest frame. If the latest frame was not
+   * reclustered, this is the result of the last frame that was, so
+   * populations and input pixels describe that frame.
+   */
+  const FlatQuantizerResult& result() const { return result_; }
+
+  /**
+   * Forgets previous frames, e.g. at a scene cut.
+   */
+  void Reset();
+
+ private:
+  TemporalQuantizerOptions options_;
+  CelebiWorkspace workspace_;
+  FlatQuantizerResult result_;
+  // Palette from before the latest recluster.
+  std::vector<Argb> previous_colors_;
+  // Whether the next recluster may start from the current palette: false
+  // if it came from a warm start that lost clusters.
+  bool reuse_palette_ = false;
+  bool has_reference_ = false;
+  // Opaque pixel counts at 4 bits per channel: of the last frame clustered,
+  // and of the latest frame.
+  std::vector<uint32_t> reference_histogram_;
+  std::vector<uint32_t> frame_histogram_;
+  uint64_t reference_count_ = 0;
+};
+
+}  // namespace material_color_utilities
+
+#endif  // CPP_QUANTIZE_TEMPORAL_QUANTIZER_H_
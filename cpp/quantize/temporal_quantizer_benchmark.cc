@@ -0,0 +1,101 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <vector>
+
+#include "testing/base/public/benchmark.h"
+#include "cpp/quantize/celebi.h"
+#include "cpp/quantize/pixel_view.h"
+#include "cpp/quantize/synthetic_images.h"
+#include "cpp/quantize/temporal_quantizer.h"
+#include "cpp/quantize/wsmeans.h"
+#include "cpp/utils/utils.h"
+
+namespace material_color_utilities {
+
+namespace {
+
+constexpr int kImageSize = 256;
+constexpr int kFrameCount = 30;
+
+// A slow cross-fade between two images, a few percent of pixels per frame,
+// standing in for a video or an animated wallpaper.
+const std::vector<std::vector<Argb>>& Frames() {
+  static const std::vector<std::vector<Argb>>* frames = [] {
+    std::vector<SyntheticImage> corpus =
+        SyntheticImageCorpus(kImageSize, kImageSize);
+    const std::vector<Argb>& from = corpus[0].pixels;
+    const std::vector<Argb>& to = corpus[1].pixels;
+    auto* frames = new std::vector<std::vector<Argb>>();
+    for (int i = 0; i < kFrameCount; i++) {
+      std::vector<Argb> frame = from;
+      size_t changed = from.size() * i / (2 * kFrameCount);
+      std::copy(to.begin(), to.begin() + changed, frame.begin());
+      frames->push_back(frame);
+    }
+    return frames;
+  }();
+  return *frames;
+}
+
+void BM_QuantizeCelebiPerFrame(benchmark::State& state) {
+  FlatQuantizerResult result;
+  for (auto s : state) {
+    for (const std::vector<Argb>& frame : Frames()) {
+      QuantizeCelebi(frame, 128, &result);
+      benchmark::DoNotOptimize(result.colors.data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kFrameCount);
+}
+BENCHMARK(BM_QuantizeCelebiPerFrame)->Unit(benchmark::kMillisecond);
+
+// Argument: reuse threshold, in thousandths; 0 warm-starts every frame.
+//
+// Besides timing, reports over the sequence:
+// `reclustered`: fraction of frames clustered rather than reused.
+// `palette_drift`: mean palette_drift of the frames clustered.
+void BM_TemporalQuantizer(benchmark::State& state) {
+  TemporalQuantizerOptions options;
+  options.reuse_threshold = state.range(0) / 1000.0;
+  int reclustered = 0;
+  double drift_sum = 0.0;
+  for (auto s : state) {
+    TemporalQuantizer quantizer(options);
+    reclustered = 0;
+    drift_sum = 0.0;
+    for (const std::vector<Argb>& frame : Frames()) {
+      TemporalFrameStats stats = quantizer.QuantizeFrame(PixelView(frame));
+      reclustered += stats.reclustered;
+      drift_sum += stats.palette_drift;
+      benchmark::DoNotOptimize(quantizer.result().colors.data());
+    }
+  }
+  state.counters["reclustered"] =
+      static_cast<double>(reclustered) / kFrameCount;
+  state.counters["palette_drift"] =
+      reclustered > 1 ? drift_sum / (reclustered - 1) : 0.0;
+  state.SetItemsProcessed(state.iterations() * kFrameCount);
+}
+BENCHMARK(BM_TemporalQuantizer)
+    ->Arg(0)
+    ->Arg(20)
+    ->Arg(50)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace material_color_utilities
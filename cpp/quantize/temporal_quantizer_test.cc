@@ -0,0 +1,177 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpp/quantize/temporal_quantizer.h"
+
+#include <vector>
+
+#include "testing/base/public/gunit.h"
+#include "cpp/quantize/celebi.h"
+#include "cpp/quantize/pixel_view.h"
+#include "cpp/quantize/synthetic_images.h"
+#include "cpp/quantize/wsmeans.h"
+#include "cpp/utils/utils.h"
+
+namespace material_color_utilities {
+
+namespace {
+
+constexpr int kSize = 64;
+
+// Returns `from` with its first `changed` pixels taken from `to`.
+std::vector<Argb> Blend(const std::vector<Argb>& from,
+                        const std::vector<Argb>& to, int changed) {
+  std::vector<Argb> pixels = from;
+  std::copy(to.begin(), to.begin() + changed, pixels.begin());
+  return pixels;
+}
+
+TEST(TemporalQuantizerTest, FirstFrameMatchesCelebi) {
+  for (const SyntheticImage& image : SyntheticImageCorpus(kSize, kSize)) {
+    TemporalQuantizer quantizer;
+    TemporalFrameStats stats = quantizer.QuantizeFrame(PixelView(image.pixels));
+    FlatQuantizerResult expected;
+    QuantizeCelebi(image.pixels, 128, &expected);
+    EXPECT_TRUE(stats.reclustered);
+    EXPECT_FALSE(stats.warm_started);
+    EXPECT_EQ(stats.histogram_delta, 1.0);
+    EXPECT_EQ(quantizer.result().colors, expected.colors);
+    EXPECT_EQ(quantizer.result().populations, expected.populations);
+  }
+}
+
+TEST(TemporalQuantizerTest, SameFrameIsNotReclustered) {
+  std::vector<Argb> pixels = SyntheticImageCorpus(kSize, kSize)[0].pixels;
+  TemporalQuantizer quantizer;
+  quantizer.QuantizeFrame(PixelView(pixels));
+  std::vector<Argb> colors = quantizer.result().colors;
+
+  TemporalFrameStats stats = quantizer.QuantizeFrame(PixelView(pixels));
+  EXPECT_FALSE(stats.reclustered);
+  EXPECT_EQ(stats.histogram_delta, 0.0);
+  EXPECT_EQ(stats.palette_drift, 0.0);
+  EXPECT_EQ(quantizer.result().colors, colors);
+}
+
+TEST(TemporalQuantizerTest, WarmStartKeepsPaletteStable) {
+  std::vector<SyntheticImage> corpus = SyntheticImageCorpus(kSize, kSize);
+  TemporalQuantizerOptions options;
+  options.max_colors = 16;
+  options.reuse_threshold = 0.0;
+  TemporalQuantizer quantizer(options);
+  quantizer.QuantizeFrame(PixelView(corpus[0].pixels));
+
+  TemporalFrameStats stats =
+      quantizer.QuantizeFrame(PixelView(corpus[0].pixels));
+  EXPECT_TRUE(stats.reclustered);
+  EXPECT_TRUE(stats.warm_started);
+  EXPECT_LT(stats.palette_drift, 1.0);
+
+  // Replacing a tenth of the frame moves the palette, but not far.
+  std::vector<Argb> next =
+      Blend(corpus[0].pixels, corpus[1].pixels, kSize * kSize / 10);
+  stats = quantizer.QuantizeFrame(PixelView(next));
+  EXPECT_TRUE(stats.warm_started);
+  EXPECT_GT(stats.histogram_delta, 0.0);
+  EXPECT_EQ(quantizer.result().colors.size(), 16u);
+}
+
+TEST(TemporalQuantizerTest, LowColorFramesWarmStart) {
+  // Four flat colors, far fewer than max_colors, in shifting proportions.
+  const Argb kColors[] = {0xffd32f2f, 0xff1976d2, 0xff388e3c, 0xfffbc02d};
+  TemporalQuantizerOptions options;
+  options.reuse_threshold = 0.0;
+  TemporalQuantizer quantizer(options);
+  for (int frame = 0; frame < 6; frame++) {
+    std::vector<Argb> pixels;
+    for (int i = 0; i < kSize * kSize; i++) {
+      pixels.push_back(kColors[(i + frame * 97) * 4 / (kSize * kSize + 1)]);
+    }
+    TemporalFrameStats stats = quantizer.QuantizeFrame(PixelView(pixels));
+    EXPECT_EQ(stats.warm_started, frame > 0) << frame;
+    EXPECT_EQ(quantizer.result().colors.size(), 4u) << frame;
+  }
+}
+
+TEST(TemporalQuantizerTest, SmallPalettesWarmStart) {
+  // Images whose palettes Wu leaves smaller than max_colors still warm-start.
+  TemporalQuantizerOptions options;
+  options.reuse_threshold = 0.0;
+  for (const SyntheticImage& image : SyntheticImageCorpus(kSize, kSize)) {
+    TemporalQuantizer quantizer(options);
+    quantizer.QuantizeFrame(PixelView(image.pixels));
+    if (quantizer.result().colors.size() >= options.max_colors) {
+      continue;
+    }
+    int warm_starts = 0;
+    for (int frame = 1; frame < 6; frame++) {
+      warm_starts += quantizer.QuantizeFrame(PixelView(image.pixels))
+                         .warm_started;
+    }
+    EXPECT_GT(warm_starts, 0) << image.name;
+  }
+}
+
+TEST(TemporalQuantizerTest, SlowDriftAddsUpToARecluster) {
+  std::vector<SyntheticImage> corpus = SyntheticImageCorpus(kSize, kSize);
+  TemporalQuantizerOptions options;
+  options.reuse_threshold = 0.05;
+  TemporalQuantizer quantizer(options);
+  quantizer.QuantizeFrame(PixelView(corpus[0].pixels));
+
+  // Each frame replaces another 1% of the first image, well below the
+  // threshold from one frame to the next.
+  int reclusters = 0;
+  for (int frame = 1; frame <= 20; frame++) {
+    std::vector<Argb> pixels = Blend(corpus[0].pixels, corpus[1].pixels,
+                                     frame * kSize * kSize / 100);
+    TemporalFrameStats stats = quantizer.QuantizeFrame(PixelView(pixels));
+    EXPECT_LT(stats.histogram_delta, 0.05 + 0.011);
+    reclusters += stats.reclustered;
+  }
+  EXPECT_GT(reclusters, 0);
+  EXPECT_LT(reclusters, 20);
+}
+
+TEST(TemporalQuantizerTest, ResetStartsOver) {
+  std::vector<SyntheticImage> corpus = SyntheticImageCorpus(kSize, kSize);
+  TemporalQuantizer quantizer;
+  quantizer.QuantizeFrame(PixelView(corpus[0].pixels));
+  quantizer.Reset();
+  EXPECT_TRUE(quantizer.result().colors.empty());
+
+  TemporalFrameStats stats =
+      quantizer.QuantizeFrame(PixelView(corpus[1].pixels));
+  FlatQuantizerResult expected;
+  QuantizeCelebi(corpus[1].pixels, 128, &expected);
+  EXPECT_FALSE(stats.warm_started);
+  EXPECT_EQ(quantizer.result().colors, expected.colors);
+}
+
+TEST(TemporalQuantizerTest, EmptyFrames) {
+  TemporalQuantizer quantizer;
+  std::vector<Argb> transparent(16, 0x00000000);
+  TemporalFrameStats stats = quantizer.QuantizeFrame(PixelView(transparent));
+  EXPECT_TRUE(stats.reclustered);
+  EXPECT_TRUE(quantizer.result().colors.empty());
+
+  stats = quantizer.QuantizeFrame(PixelView(transparent));
+  EXPECT_FALSE(stats.reclustered);
+  EXPECT_EQ(stats.histogram_delta, 0.0);
+}
+
+}  // namespace
+}  // namespace material_color_utilities
@@ -17,221 +17,710 @@
 #include "cpp/quantize/wsmeans.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <cstdint>
 #include <cstdlib>
+#include <limits>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
+#include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
-#include "absl/container/flat_hash_map.h"
+#include "absl/types/span.h"
 #include "cpp/quantize/lab.h"
-
-constexpr int kMaxIterations = 100;
-constexpr double kMinDeltaE = 3.0;
+#include "cpp/quantize/lab_distance.h"
+#include "cpp/quantize/pixel_view.h"
+#include "cpp/utils/parallel.h"
+
+// Points per unit of parallel work. Partial sums are formed per block and
+// combined in block order, so this, not the thread count, determines the
+// floating-point summation order.
+constexpr int kPointsPerBlock = 4096;
+// Allowance for rounding in distance bounds, well above the error of
+// single-precision distances.
+constexpr double kBoundSlack = 1e-3;
 
 namespace material_color_utilities {
 
+/**
+ * A seedable generator producing the same sequence as glibc's rand(), so
+ * results match those QuantizeWsmeans gave when it used the process-wide
+ * generator, while concurrent calls no longer share state.
+ */
+class Random {
+ public:
+  static constexpr int kMax = 2147483647;
+
+  explicit Random(uint32_t seed) {
+    int64_t word = seed == 0 ? 1 : seed;
+    state_[0] = word;
+    for (int i = 1; i < kDegree; i++) {
+      // word = (16807 * word) % 2147483647, without overflowing 31 bits.
+      int64_t hi = word / 127773;
+      int64_t lo = word % 127773;
+      word = 16807 * lo - 2836 * hi;
+      if (word < 0) {
+        word += 2147483647;
+      }
+      state_[i] = word;
+    }
+    front_ = kSeparation;
+    rear_ = 0;
+    for (int i = 0; i < 10 * kDegree; i++) {
+      Next();
+    }
+  }
+
+  /**
+   * Returns a number in [0, kMax].
+   */
+  int Next() {
+    state_[front_] += state_[rear_];
+    int result = state_[front_] >> 1;
+    front_ = (front_ + 1) % kDegree;
+    rear_ = (rear_ + 1) % kDegree;
+    return result;
+  }
+
+ private:
+  static constexpr int kDegree = 31;
+  static constexpr int kSeparation = 3;
+
+  uint32_t state_[kDegree];
+  int front_;
+  int rear_;
+};
+
 struct Swatch {
   Argb argb = 0;
-  int population = 0;
+  double weight = 0.0;
+};
 
-  bool operator<(const Swatch& b) const { return population > b.population; }
+/**
+ * Per-cluster sums over one block of points of precision T, weighted by pixel
+ * count or caller-given weight. Weights are summed in double precision, so
+ * that populations stay exact.
+ */
+template <typename T>
+struct ClusterSums {
+  std::vector<double> weights;
+  std::vector<T> l;
+  std::vector<T> a;
+  std::vector<T> b;
 };
 
-struct DistanceToIndex {
-  double distance = 0.0;
-  int index = 0;
+/**
+ * Bounds on each point's distance to clusters, carried across iterations.
+ * `upper`: at least the distance to the point's own cluster.
+ * `lower`: at most the distance to any other cluster.
+ */
+struct PointBounds {
+  std::vector<double> upper;
+  std::vector<double> lower;
+};
 
-  bool operator<(const DistanceToIndex& a) const {
-    return distance < a.distance;
-  }
+/**
+ * Squared distance from `point` to cluster `index`, computed with the same
+ * operations as SquaredLabDistances.
+ */
+template <typename P, typename T>
+T SquaredDistance(const BasicLab<P>& point, const LabArrays<T>& clusters,
+                  int index) {
+  T d_l = static_cast<T>(point.l) - clusters.l[index];
+  T d_a = static_cast<T>(point.a) - clusters.a[index];
+  T d_b = static_cast<T>(point.b) - clusters.b[index];
+  return (d_l * d_l) + (d_a * d_a) + (d_b * d_b);
+}
+
+/**
+ * Whether bounds prove a point cannot move: a point moves only if another
+ * cluster is more than `min_delta_e` closer than its own.
+ */
+inline bool BoundsRuleOutMove(double upper, double lower, double min_delta_e) {
+  return lower - kBoundSlack > upper - min_delta_e;
+}
+
+/**
+ * Counters gathered by ReassignPoints over one block of points, for
+ * WsmeansStats.
+ */
+struct ReassignCounts {
+  int64_t points_moved = 0;
+  int64_t distances_computed = 0;
+  int64_t distances_skipped = 0;
+  int64_t comparisons_skipped = 0;
 };
 
-QuantizerResult QuantizeWsmeans(const std::vector<Argb>& input_pixels,
-                                const std::vector<Argb>& starting_clusters,
-                                uint16_t max_colors) {
-  if (max_colors == 0 || input_pixels.empty()) {
-    return QuantizerResult();
+/**
+ * Moves each point in [begin, end) to its nearest cluster, if that is
+ * sufficiently closer than its current one. Distances from a point to every
+ * cluster are computed at once by the SIMD kernel; clusters that the
+ * triangle inequality rules out are still skipped when picking the nearest.
+ *
+ * If `bounds` is given, points whose bounds rule out a move are skipped
+ * without computing distances, and the bounds of the rest are reset to the
+ * distances computed.
+ *
+ * `distances` is scratch space, reused across calls. Counters are added to
+ * `counts` only when kCountStats is set, so uninstrumented calls do no extra
+ * work.
+ *
+ * @return whether any point changed clusters.
+ */
+template <bool kCountStats, typename P, typename T>
+bool ReassignPoints(SimdLevel simd_level,
+                    const std::vector<BasicLab<P>>& points,
+                    const LabArrays<T>& clusters,
+                    const std::vector<std::vector<P>>& cluster_distances,
+                    size_t begin, size_t end, std::vector<int>& cluster_indices,
+                    double min_delta_e, PointBounds* bounds,
+                    std::vector<T>& distances, ReassignCounts* counts) {
+  int cluster_count = clusters.size();
+  distances.resize(cluster_count);
+  bool color_moved = false;
+  // Counted in locals, which the compiler can keep in registers, rather than
+  // through `counts`.
+  ReassignCounts local_counts;
+  for (size_t i = begin; i < end; i++) {
+    if (bounds != nullptr) {
+      double& upper = bounds->upper[i];
+      if (BoundsRuleOutMove(upper, bounds->lower[i], min_delta_e)) {
+        if constexpr (kCountStats) {
+          local_counts.distances_skipped += cluster_count;
+        }
+        continue;
+      }
+      // The upper bound may have grown loose; tighten it and try again.
+      upper = sqrt(
+          static_cast<double>(SquaredDistance(points[i], clusters,
+                                              cluster_indices[i])));
+      if constexpr (kCountStats) {
+        local_counts.distances_computed++;
+      }
+      if (BoundsRuleOutMove(upper, bounds->lower[i], min_delta_e)) {
+        if constexpr (kCountStats) {
+          local_counts.distances_skipped += cluster_count - 1;
+        }
+        continue;
+      }
+    }
+
+    SquaredLabDistances(simd_level, points[i], clusters, distances.data());
+    if constexpr (kCountStats) {
+      local_counts.distances_computed += cluster_count;
+    }
+
+    int previous_cluster_index = cluster_indices[i];
+    const std::vector<P>& previous_cluster_distances =
+        cluster_distances[previous_cluster_index];
+    T previous_distance = distances[previous_cluster_index];
+    T minimum_distance = previous_distance;
+    int new_cluster_index = -1;
+
+    for (int j = 0; j < cluster_count; j++) {
+      if (previous_cluster_distances[j] >= 4 * previous_distance) {
+        if constexpr (kCountStats) {
+          local_counts.comparisons_skipped++;
+        }
+        continue;
+      }
+      if (distances[j] < minimum_distance) {
+        minimum_distance = distances[j];
+        new_cluster_index = j;
+      }
+    }
+    if (new_cluster_index != -1) {
+      double minimum = minimum_distance;
+      double previous = previous_distance;
+      double distanceChange = std::abs(sqrt(minimum) - sqrt(previous));
+      if (distanceChange > min_delta_e) {
+        color_moved = true;
+        cluster_indices[i] = new_cluster_index;
+        if constexpr (kCountStats) {
+          local_counts.points_moved++;
+        }
+      }
+    }
+
+    if (bounds != nullptr) {
+      int cluster_index = cluster_indices[i];
+      double nearest_other = std::numeric_limits<double>::infinity();
+      for (int j = 0; j < cluster_count; j++) {
+        if (j != cluster_index && distances[j] < nearest_other) {
+          nearest_other = distances[j];
+        }
+      }
+      bounds->upper[i] = sqrt(static_cast<double>(distances[cluster_index]));
+      bounds->lower[i] = sqrt(nearest_other);
+    }
+  }
+  if constexpr (kCountStats) {
+    counts->points_moved += local_counts.points_moved;
+    counts->distances_computed += local_counts.distances_computed;
+    counts->distances_skipped += local_counts.distances_skipped;
+    counts->comparisons_skipped += local_counts.comparisons_skipped;
   }
+  return color_moved;
+}
 
-  if (max_colors > 256) {
-    // If colors is outside the range, just set it the max.
-    max_colors = 256;
+template <typename P, typename T>
+bool ReassignPoints(SimdLevel simd_level,
+                    const std::vector<BasicLab<P>>& points,
+                    const LabArrays<T>& clusters,
+                    const std::vector<std::vector<P>>& cluster_distances,
+                    size_t begin, size_t end, std::vector<int>& cluster_indices,
+                    double min_delta_e, PointBounds* bounds,
+                    std::vector<T>& distances, ReassignCounts* counts) {
+  if (counts != nullptr) {
+    return ReassignPoints<true>(simd_level, points, clusters,
+                                cluster_distances, begin, end, cluster_indices,
+                                min_delta_e, bounds, distances, counts);
+  }
+  return ReassignPoints<false>(simd_level, points, clusters, cluster_distances,
+                               begin, end, cluster_indices, min_delta_e,
+                               bounds, distances, counts);
+}
+
+/**
+ * Loosens the bounds of the points in [begin, end) by how far each cluster
+ * moved, so that they hold for the new cluster centers.
+ */
+void UpdateBounds(const std::vector<int>& cluster_indices,
+                  const std::vector<double>& drifts, int farthest_drift_index,
+                  double second_farthest_drift, size_t begin, size_t end,
+                  PointBounds& bounds) {
+  double farthest_drift = drifts[farthest_drift_index];
+  for (size_t i = begin; i < end; i++) {
+    int cluster_index = cluster_indices[i];
+    bounds.upper[i] += drifts[cluster_index];
+    bounds.lower[i] -= cluster_index == farthest_drift_index
+                           ? second_farthest_drift
+                           : farthest_drift;
+  }
+}
+
+/**
+ * Sums the points in [begin, end) into their clusters, starting from zero.
+ */
+template <typename T>
+void SumClusters(const std::vector<BasicLab<T>>& points,
+                 const std::vector<double>& point_weights,
+                 const std::vector<int>& cluster_indices, size_t begin,
+                 size_t end, int cluster_count, ClusterSums<T>& sums) {
+  sums.weights.assign(cluster_count, 0.0);
+  sums.l.assign(cluster_count, 0);
+  sums.a.assign(cluster_count, 0);
+  sums.b.assign(cluster_count, 0);
+  for (size_t i = begin; i < end; i++) {
+    int clusterIndex = cluster_indices[i];
+    const BasicLab<T>& point = points[i];
+    T weight = static_cast<T>(point_weights[i]);
+
+    sums.weights[clusterIndex] += point_weights[i];
+    sums.l[clusterIndex] += (point.l * weight);
+    sums.a[clusterIndex] += (point.a * weight);
+    sums.b[clusterIndex] += (point.b * weight);
+  }
+}
+
+/**
+ * Maps colors to their index in a list of distinct colors, in order of first
+ * appearance. Unlike absl::flat_hash_map, which frees large tables when
+ * cleared, it keeps its storage, so a reused workspace stops allocating.
+ */
+class ColorIndexTable {
+ public:
+  /**
+   * Empties the table, keeping its storage.
+   */
+  void Clear() { std::fill(slots_.begin(), slots_.end(), kEmpty); }
+
+  /**
+   * Returns the index of `color` in `colors`, first appending it if the
+   * table has not seen it. `colors` must hold exactly the colors inserted
+   * since the table was last cleared.
+   */
+  int FindOrInsert(Argb color, std::vector<Argb>& colors) {
+    if (2 * (colors.size() + 1) > slots_.size()) {
+      Grow(colors);
+    }
+    size_t mask = slots_.size() - 1;
+    for (size_t slot = Hash(color) & mask;; slot = (slot + 1) & mask) {
+      int index = slots_[slot];
+      if (index == kEmpty) {
+        slots_[slot] = colors.size();
+        colors.push_back(color);
+        return slots_[slot];
+      }
+      if (colors[index] == color) {
+        return index;
+      }
+    }
   }
 
-  uint32_t pixel_count = input_pixels.size();
-  absl::flat_hash_map<Argb, int> pixel_to_count;
-  std::vector<uint32_t> pixels;
-  pixels.reserve(pixel_count);
-  std::vector<Lab> points;
-  points.reserve(pixel_count);
-  for (Argb pixel : input_pixels) {
-    // tested over 1000 runs with 128 colors, 12544 (112 x 112)
-    // std::map 10.9 ms
-    // std::unordered_map 10.2 ms
-    // absl::btree_map 9.0 ms
-    // absl::flat_hash_map 8.0 ms
-    absl::flat_hash_map<Argb, int>::iterator it = pixel_to_count.find(pixel);
-    if (it != pixel_to_count.end()) {
-      it->second++;
+ private:
+  static constexpr int kEmpty = -1;
+
+  static size_t Hash(Argb color) {
+    return (color * 0x9e3779b97f4a7c15u) >> 32;
+  }
+
+  void Grow(const std::vector<Argb>& colors) {
+    slots_.assign(std::max<size_t>(1024, 2 * slots_.size()), kEmpty);
+    size_t mask = slots_.size() - 1;
+    for (size_t i = 0; i < colors.size(); i++) {
+      size_t slot = Hash(colors[i]) & mask;
+      while (slots_[slot] != kEmpty) {
+        slot = (slot + 1) & mask;
+      }
+      slots_[slot] = i;
+    }
+  }
 
+  // Indices into the list of colors; the size is a power of two.
+  std::vector<int> slots_;
+};
+
+/**
+ * The buffers of QuantizePoints that hold values of one precision, T. A call
+ * uses the point buffers of its point precision and the distance buffers of
+ * its distance precision, which may differ.
+ */
+template <typename T>
+struct PrecisionBuffers {
+  // The L*a*b* points of the distinct input colors, and the clusters.
+  std::vector<BasicLab<T>> points;
+  std::vector<BasicLab<T>> clusters;
+  std::vector<BasicLab<T>> previous_clusters;
+  std::vector<std::vector<T>> cluster_distances;
+  std::vector<ClusterSums<T>> block_sums;
+
+  // Distances from points to clusters.
+  LabArrays<T> cluster_arrays;
+  std::vector<std::vector<T>> block_distances;
+};
+
+/**
+ * Everything QuantizeWsmeans allocates, kept by a WsmeansWorkspace so that
+ * later calls reuse its capacity.
+ */
+struct WsmeansBuffers {
+  ColorIndexTable color_indices;
+  // The colors of the points to cluster and their weights: the distinct
+  // input colors, or with bucketing, the mean color of each bucket.
+  std::vector<Argb> pixels;
+  std::vector<double> point_weights;
+
+  // With bucketing, the distinct input colors, their weights, and the index
+  // of the point each was merged into.
+  std::vector<Argb> input_pixels;
+  std::vector<double> input_weights;
+  std::vector<int> input_points;
+  ColorIndexTable bucket_indices;
+  std::vector<Argb> bucket_keys;
+  std::vector<double> bucket_sums;
+
+  PrecisionBuffers<double> doubles;
+  PrecisionBuffers<float> floats;
+
+  template <typename T>
+  PrecisionBuffers<T>& Precision() {
+    if constexpr (std::is_same<T, float>::value) {
+      return floats;
     } else {
-      pixels.push_back(pixel);
-      points.push_back(LabFromInt(pixel));
-      pixel_to_count[pixel] = 1;
+      return doubles;
     }
   }
 
+  std::vector<int> cluster_indices;
+  std::vector<char> block_moved;
+  std::vector<ReassignCounts> block_counts;
+  PointBounds bounds;
+  std::vector<double> drifts;
+
+  std::vector<Swatch> swatches;
+  std::vector<Argb> all_cluster_argbs;
+  std::vector<uint64_t> pixel_keys;
+};
+
+WsmeansWorkspace::WsmeansWorkspace()
+    : buffers_(std::make_unique<WsmeansBuffers>()) {}
+
+WsmeansWorkspace::~WsmeansWorkspace() = default;
+
+WsmeansWorkspace::WsmeansWorkspace(WsmeansWorkspace&&) = default;
+
+WsmeansWorkspace& WsmeansWorkspace::operator=(WsmeansWorkspace&&) = default;
+
+/**
+ * Clusters the distinct colors in `buffers.pixels`, with positive
+ * `point_weights`. Points and clusters are held in precision T, and distances
+ * from points to clusters are computed in precision D. `start` is when the
+ * call began, which the time budget counts from.
+ */
+template <typename T, typename D>
+void QuantizePoints(const std::vector<Argb>& starting_clusters,
+                    uint16_t max_colors, const WsmeansOptions& options,
+                    std::chrono::steady_clock::time_point start,
+                    WsmeansBuffers& buffers, FlatQuantizerResult* result,
+                    WsmeansStats* stats) {
+  const std::vector<Argb>& pixels = buffers.pixels;
+  const std::vector<double>& point_weights = buffers.point_weights;
+  PrecisionBuffers<T>& point_buffers = buffers.Precision<T>();
+  PrecisionBuffers<D>& distance_buffers = buffers.Precision<D>();
+  std::vector<BasicLab<T>>& points = point_buffers.points;
+  points.resize(pixels.size());
+  LabFromInts(pixels, absl::MakeSpan(points));
+  result->Clear();
+  bool bucketed = options.bucketing != WsmeansBucketing::kNone;
+  const std::vector<Argb>& input_pixels =
+      bucketed ? buffers.input_pixels : pixels;
+  if (stats != nullptr) {
+    stats->distinct_colors = input_pixels.size();
+    stats->points = points.size();
+    stats->clusters = 0;
+    stats->iterations = 0;
+    stats->points_moved.clear();
+    stats->distances_computed = 0;
+    stats->distances_skipped = 0;
+    stats->comparisons_skipped = 0;
+  }
+  if (max_colors == 0 || points.empty()) {
+    return;
+  }
+
+  if (max_colors > 256) {
+    // If colors is outside the range, just set it the max.
+    max_colors = 256;
+  }
+
   int cluster_count = std::min((int)max_colors, (int)points.size());
 
   if (!starting_clusters.empty()) {
     cluster_count = std::min(cluster_count, (int)starting_clusters.size());
   }
+  if (stats != nullptr) {
+    stats->clusters = cluster_count;
+  }
 
-  int pixel_count_sums[256] = {};
-  std::vector<Lab> clusters;
-  clusters.reserve(starting_clusters.size());
+  double weight_sums[256] = {};
+  std::vector<BasicLab<T>>& clusters = point_buffers.clusters;
+  clusters.clear();
   for (int argb : starting_clusters) {
-    clusters.push_back(LabFromInt(argb));
+    clusters.push_back(LabCast<T>(LabFromInt(argb)));
   }
 
-  srand(42688);
   int additional_clusters_needed = cluster_count - clusters.size();
   if (starting_clusters.empty() && additional_clusters_needed > 0) {
+    Random random(options.seed);
     for (int i = 0; i < additional_clusters_needed; i++) {
       // Adds a random Lab color to clusters.
-      double l = rand() / (static_cast<double>(RAND_MAX)) * (100.0) + 0.0;
-      double a =
-          rand() / (static_cast<double>(RAND_MAX)) * (100.0 - -100.0) - 100.0;
-      double b =
-          rand() / (static_cast<double>(RAND_MAX)) * (100.0 - -100.0) - 100.0;
-      clusters.push_back({l, a, b});
+      double l =
+          random.Next() / (static_cast<double>(Random::kMax)) * (100.0) + 0.0;
+      double a = random.Next() / (static_cast<double>(Random::kMax)) *
+                     (100.0 - -100.0) -
+                 100.0;
+      double b = random.Next() / (static_cast<double>(Random::kMax)) *
+                     (100.0 - -100.0) -
+                 100.0;
+      clusters.push_back(LabCast<T>(Lab{l, a, b}));
     }
   }
 
-  std::vector<int> cluster_indices;
-  cluster_indices.reserve(points.size());
+  std::vector<int>& cluster_indices = buffers.cluster_indices;
+  cluster_indices.clear();
 
-  srand(42688);
+  Random random(options.seed);
   for (size_t i = 0; i < points.size(); i++) {
-    cluster_indices.push_back(rand() % cluster_count);
+    cluster_indices.push_back(random.Next() % cluster_count);
   }
 
-  std::vector<std::vector<int>> index_matrix(
-      cluster_count, std::vector<int>(cluster_count, 0));
+  std::vector<std::vector<T>>& cluster_distances =
+      point_buffers.cluster_distances;
+  cluster_distances.resize(cluster_count);
+  for (std::vector<T>& row : cluster_distances) {
+    row.assign(cluster_count, 0);
+  }
 
-  std::vector<std::vector<DistanceToIndex>> distance_to_index_matrix(
-      cluster_count, std::vector<DistanceToIndex>(cluster_count));
+  SimdLevel simd_level = BestSimdLevel();
+  LabArrays<D>& cluster_arrays = distance_buffers.cluster_arrays;
+  cluster_arrays.Resize(cluster_count);
+
+  int block_count = (points.size() + kPointsPerBlock - 1) / kPointsPerBlock;
+  std::vector<char>& block_moved = buffers.block_moved;
+  block_moved.resize(block_count);
+  std::vector<ReassignCounts>& block_counts = buffers.block_counts;
+  std::vector<ClusterSums<T>>& block_sums = point_buffers.block_sums;
+  block_sums.resize(block_count);
+  std::vector<std::vector<D>>& block_distances =
+      distance_buffers.block_distances;
+  block_distances.resize(block_count);
+
+  PointBounds& point_bounds = buffers.bounds;
+  PointBounds* bounds = nullptr;
+  std::vector<BasicLab<T>>& previous_clusters =
+      point_buffers.previous_clusters;
+  std::vector<double>& drifts = buffers.drifts;
+  drifts.resize(cluster_count);
+  if (options.acceleration == WsmeansAcceleration::kHamerly) {
+    // Unknown bounds never rule out a move.
+    point_bounds.upper.assign(points.size(),
+                              std::numeric_limits<double>::infinity());
+    point_bounds.lower.assign(points.size(), 0.0);
+    bounds = &point_bounds;
+  }
 
-  for (int iteration = 0; iteration < kMaxIterations; iteration++) {
+  // Distances are counted for the distance budget as well as for stats.
+  bool count_distances = stats != nullptr || options.distance_budget > 0;
+  int64_t distances_computed = 0;
+  int max_iterations = std::max(1, options.max_iterations);
+  bool converged = false;
+  for (int iteration = 0; iteration < max_iterations; iteration++) {
     // Calculate cluster distances
     for (int i = 0; i < cluster_count; i++) {
-      distance_to_index_matrix[i][i].distance = 0;
-      distance_to_index_matrix[i][i].index = i;
       for (int j = i + 1; j < cluster_count; j++) {
-        double distance = clusters[i].DeltaE(clusters[j]);
-
-        distance_to_index_matrix[j][i].distance = distance;
-        distance_to_index_matrix[j][i].index = i;
-        distance_to_index_matrix[i][j].distance = distance;
-        distance_to_index_matrix[i][j].index = j;
-      }
-
-      std::vector<DistanceToIndex> row = distance_to_index_matrix[i];
-      std::sort(row.begin(), row.end());
-
-      for (int j = 0; j < cluster_count; j++) {
-        index_matrix[i][j] = row[j].index;
+        T distance = clusters[i].DeltaE(clusters[j]);
+        cluster_distances[j][i] = distance;
+        cluster_distances[i][j] = distance;
       }
     }
 
     // Reassign points
-    bool color_moved = false;
-    for (size_t i = 0; i < points.size(); i++) {
-      Lab point = points[i];
-
-      int previous_cluster_index = cluster_indices[i];
-      Lab previous_cluster = clusters[previous_cluster_index];
-      double previous_distance = point.DeltaE(previous_cluster);
-      double minimum_distance = previous_distance;
-      int new_cluster_index = -1;
-
-      for (int j = 0; j < cluster_count; j++) {
-        if (distance_to_index_matrix[previous_cluster_index][j].distance >=
-            4 * previous_distance) {
-          continue;
-        }
-        double distance = point.DeltaE(clusters[j]);
-        if (distance < minimum_distance) {
-          minimum_distance = distance;
-          new_cluster_index = j;
-        }
+    for (int i = 0; i < cluster_count; i++) {
+      cluster_arrays.Set(i, clusters[i]);
+    }
+    if (count_distances) {
+      block_counts.assign(block_count, ReassignCounts());
+    }
+    ParallelFor(options.num_threads, block_count, [&](int block) {
+      size_t begin = static_cast<size_t>(block) * kPointsPerBlock;
+      size_t end = std::min(points.size(), begin + kPointsPerBlock);
+      ReassignCounts* counts =
+          count_distances ? &block_counts[block] : nullptr;
+      block_moved[block] = ReassignPoints(
+          simd_level, points, cluster_arrays, cluster_distances, begin, end,
+          cluster_indices, options.min_delta_e, bounds, block_distances[block],
+          counts);
+    });
+    bool color_moved = std::any_of(block_moved.begin(), block_moved.end(),
+                                   [](char moved) { return moved; });
+    if (count_distances) {
+      for (const ReassignCounts& counts : block_counts) {
+        distances_computed += counts.distances_computed;
       }
-      if (new_cluster_index != -1) {
-        double distanceChange =
-            abs(sqrt(minimum_distance) - sqrt(previous_distance));
-        if (distanceChange > kMinDeltaE) {
-          color_moved = true;
-          cluster_indices[i] = new_cluster_index;
-        }
+    }
+    if (stats != nullptr) {
+      stats->iterations++;
+      int64_t points_moved = 0;
+      for (const ReassignCounts& counts : block_counts) {
+        points_moved += counts.points_moved;
+        stats->distances_skipped += counts.distances_skipped;
+        stats->comparisons_skipped += counts.comparisons_skipped;
       }
+      stats->points_moved.push_back(points_moved);
+      stats->distances_computed = distances_computed;
     }
 
     if (!color_moved && (iteration != 0)) {
+      converged = true;
       break;
     }
 
     // Recalculate cluster centers
+    ParallelFor(options.num_threads, block_count, [&](int block) {
+      size_t begin = static_cast<size_t>(block) * kPointsPerBlock;
+      size_t end = std::min(points.size(), begin + kPointsPerBlock);
+      SumClusters(points, point_weights, cluster_indices, begin, end,
+                  cluster_count, block_sums[block]);
+    });
+
+    // Combines blocks in a fixed order, so the result does not depend on how
+    // blocks were scheduled across threads.
     double component_a_sums[256] = {};
     double component_b_sums[256] = {};
     double component_c_sums[256] = {};
     for (int i = 0; i < cluster_count; i++) {
-      pixel_count_sums[i] = 0;
+      weight_sums[i] = 0.0;
     }
-
-    for (size_t i = 0; i < points.size(); i++) {
-      int clusterIndex = cluster_indices[i];
-      Lab point = points[i];
-      int count = pixel_to_count[pixels[i]];
-
-      pixel_count_sums[clusterIndex] += count;
-      component_a_sums[clusterIndex] += (point.l * count);
-      component_b_sums[clusterIndex] += (point.a * count);
-      component_c_sums[clusterIndex] += (point.b * count);
+    for (int block = 0; block < block_count; block++) {
+      const ClusterSums<T>& sums = block_sums[block];
+      for (int i = 0; i < cluster_count; i++) {
+        weight_sums[i] += sums.weights[i];
+        component_a_sums[i] += sums.l[i];
+        component_b_sums[i] += sums.a[i];
+        component_c_sums[i] += sums.b[i];
+      }
     }
 
+    if (bounds != nullptr) {
+      previous_clusters = clusters;
+    }
     for (int i = 0; i < cluster_count; i++) {
-      int count = pixel_count_sums[i];
-      if (count == 0) {
+      double weight = weight_sums[i];
+      if (weight == 0) {
         clusters[i] = {0, 0, 0};
         continue;
       }
-      double a = component_a_sums[i] / count;
-      double b = component_b_sums[i] / count;
-      double c = component_c_sums[i] / count;
-      clusters[i] = {a, b, c};
+      double a = component_a_sums[i] / weight;
+      double b = component_b_sums[i] / weight;
+      double c = component_c_sums[i] / weight;
+      clusters[i] = LabCast<T>(Lab{a, b, c});
+    }
+
+    if (bounds != nullptr) {
+      int farthest_drift_index = 0;
+      double second_farthest_drift = 0.0;
+      for (int i = 0; i < cluster_count; i++) {
+        drifts[i] =
+            sqrt(static_cast<double>(previous_clusters[i].DeltaE(clusters[i])));
+        if (drifts[i] > drifts[farthest_drift_index]) {
+          second_farthest_drift = drifts[farthest_drift_index];
+          farthest_drift_index = i;
+        } else if (i != farthest_drift_index &&
+                   drifts[i] > second_farthest_drift) {
+          second_farthest_drift = drifts[i];
+        }
+      }
+      ParallelFor(options.num_threads, block_count, [&](int block) {
+        size_t begin = static_cast<size_t>(block) * kPointsPerBlock;
+        size_t end = std::min(points.size(), begin + kPointsPerBlock);
+        UpdateBounds(cluster_indices, drifts, farthest_drift_index,
+                     second_farthest_drift, begin, end, point_bounds);
+      });
+    }
+
+    if (options.distance_budget > 0 &&
+        distances_computed >= options.distance_budget) {
+      break;
+    }
+    if (options.time_budget.count() > 0 &&
+        std::chrono::steady_clock::now() - start >= options.time_budget) {
+      break;
     }
   }
+  result->converged = converged;
 
-  std::vector<Swatch> swatches;
-  std::vector<Argb> cluster_argbs;
-  std::vector<Argb> all_cluster_argbs;
+  std::vector<Swatch>& swatches = buffers.swatches;
+  swatches.clear();
+  std::vector<Argb>& all_cluster_argbs = buffers.all_cluster_argbs;
+  all_cluster_argbs.clear();
   for (int i = 0; i < cluster_count; i++) {
-    Argb possible_new_cluster = IntFromLab(clusters[i]);
+    Argb possible_new_cluster = IntFromLab(LabCast<double>(clusters[i]));
     all_cluster_argbs.push_back(possible_new_cluster);
 
-    int count = pixel_count_sums[i];
-    if (count == 0) {
+    double weight = weight_sums[i];
+    if (weight == 0) {
       continue;
     }
     int use_new_cluster = 1;
     for (size_t j = 0; j < swatches.size(); j++) {
       if (swatches[j].argb == possible_new_cluster) {
-        swatches[j].population += count;
+        swatches[j].weight += weight;
         use_new_cluster = 0;
         break;
       }
@@ -240,27 +729,238 @@ QuantizerResult QuantizeWsmeans(const std::vector<Argb>& input_pixels,
     if (use_new_cluster == 0) {
       continue;
     }
-    cluster_argbs.push_back(possible_new_cluster);
-    swatches.push_back({possible_new_cluster, count});
+    swatches.push_back({possible_new_cluster, weight});
   }
-  std::sort(swatches.begin(), swatches.end());
+  // Sorted by color, the order the legacy std::map result iterates in.
+  std::sort(swatches.begin(), swatches.end(),
+            [](const Swatch& a, const Swatch& b) { return a.argb < b.argb; });
 
   // Constructs the quantizer result to return.
+  for (const Swatch& swatch : swatches) {
+    result->colors.push_back(swatch.argb);
+    // Exact for pixel counts. Fractional weights are rounded, but never to
+    // 0, which would drop a color that points are assigned to.
+    result->populations.push_back(
+        std::max<long long>(1, std::llround(swatch.weight)));
+  }
 
-  std::map<Argb, uint32_t> color_to_count;
-  for (size_t i = 0; i < swatches.size(); i++) {
-    color_to_count[swatches[i].argb] = swatches[i].population;
+  // Every point's cluster has a nonzero population, so its color is in the
+  // palette.
+  uint8_t palette_indices[256];
+  for (int i = 0; i < cluster_count; i++) {
+    palette_indices[i] =
+        std::lower_bound(result->colors.begin(), result->colors.end(),
+                         all_cluster_argbs[i]) -
+        result->colors.begin();
   }
 
-  std::map<Argb, Argb> input_pixel_to_cluster_pixel;
-  for (size_t i = 0; i < points.size(); i++) {
-    int pixel = pixels[i];
-    int cluster_index = cluster_indices[i];
-    int cluster_argb = all_cluster_argbs[cluster_index];
-    input_pixel_to_cluster_pixel[pixel] = cluster_argb;
+  // Sorting packed (pixel, palette index) keys orders the distinct input
+  // colors without a node allocation per color.
+  std::vector<uint64_t>& pixel_keys = buffers.pixel_keys;
+  pixel_keys.clear();
+  for (size_t i = 0; i < input_pixels.size(); i++) {
+    int point = bucketed ? buffers.input_points[i] : i;
+    pixel_keys.push_back((static_cast<uint64_t>(input_pixels[i]) << 8) |
+                         palette_indices[cluster_indices[point]]);
+  }
+  std::sort(pixel_keys.begin(), pixel_keys.end());
+  result->input_pixels.resize(pixel_keys.size());
+  result->cluster_indices.resize(pixel_keys.size());
+  for (size_t i = 0; i < pixel_keys.size(); i++) {
+    result->input_pixels[i] = pixel_keys[i] >> 8;
+    result->cluster_indices[i] = pixel_keys[i] & 0xff;
+  }
+}
+
+/**
+ * Returns the bits of a color that colors merged by `bucketing` share.
+ */
+Argb BucketMask(WsmeansBucketing bucketing) {
+  switch (bucketing) {
+    case WsmeansBucketing::kRgb666:
+      return 0x00fcfcfc;
+    case WsmeansBucketing::kRgb565:
+      return 0x00f8fcf8;
+    default:
+      return 0x00ffffff;
+  }
+}
+
+/**
+ * Moves the distinct colors in `buffers.pixels` to `buffers.input_pixels`,
+ * and replaces them with one point per bucket of colors that agree in the
+ * bits of `mask`: the weighted mean of the bucket's colors, carrying their
+ * total weight. Buckets are listed in the order their first color appears.
+ */
+void MergeIntoBuckets(Argb mask, WsmeansBuffers& buffers) {
+  std::vector<Argb>& pixels = buffers.pixels;
+  std::vector<double>& point_weights = buffers.point_weights;
+  std::vector<Argb>& input_pixels = buffers.input_pixels;
+  std::vector<double>& input_weights = buffers.input_weights;
+  input_pixels.swap(pixels);
+  input_weights.swap(point_weights);
+  pixels.clear();
+  point_weights.clear();
+
+  std::vector<Argb>& bucket_keys = buffers.bucket_keys;
+  std::vector<double>& sums = buffers.bucket_sums;
+  bucket_keys.clear();
+  sums.clear();
+  buffers.bucket_indices.Clear();
+  buffers.input_points.resize(input_pixels.size());
+  for (size_t i = 0; i < input_pixels.size(); i++) {
+    Argb color = input_pixels[i];
+    double weight = input_weights[i];
+    size_t bucket =
+        buffers.bucket_indices.FindOrInsert(color & mask, bucket_keys);
+    if (bucket == point_weights.size()) {
+      point_weights.push_back(0.0);
+      sums.resize(sums.size() + 3, 0.0);
+    }
+    point_weights[bucket] += weight;
+    sums[3 * bucket] += weight * RedFromInt(color);
+    sums[3 * bucket + 1] += weight * GreenFromInt(color);
+    sums[3 * bucket + 2] += weight * BlueFromInt(color);
+    buffers.input_points[i] = bucket;
+  }
+
+  pixels.resize(bucket_keys.size());
+  for (size_t i = 0; i < pixels.size(); i++) {
+    double weight = point_weights[i];
+    pixels[i] = ArgbFromRgb(std::lround(sums[3 * i] / weight),
+                            std::lround(sums[3 * i + 1] / weight),
+                            std::lround(sums[3 * i + 2] / weight));
+  }
+}
+
+/**
+ * Clusters the distinct colors in `buffers.pixels`, first merging them into
+ * buckets if `options.bucketing` asks to, with the arithmetic that
+ * `options.precision` selects.
+ */
+void QuantizeColors(const std::vector<Argb>& starting_clusters,
+                    uint16_t max_colors, const WsmeansOptions& options,
+                    std::chrono::steady_clock::time_point start,
+                    WsmeansBuffers& buffers, FlatQuantizerResult* result,
+                    WsmeansStats* stats) {
+  if (options.bucketing != WsmeansBucketing::kNone) {
+    MergeIntoBuckets(BucketMask(options.bucketing), buffers);
+  }
+  switch (options.precision) {
+    case WsmeansPrecision::kFast:
+      QuantizePoints<double, float>(starting_clusters, max_colors, options,
+                                    start, buffers, result, stats);
+      return;
+    case WsmeansPrecision::kFloat32:
+      QuantizePoints<float, float>(starting_clusters, max_colors, options,
+                                   start, buffers, result, stats);
+      return;
+    default:
+      QuantizePoints<double, double>(starting_clusters, max_colors, options,
+                                     start, buffers, result, stats);
+      return;
+  }
+}
+
+void QuantizeWsmeans(const std::vector<Argb>& input_pixels,
+                     const std::vector<Argb>& starting_clusters,
+                     uint16_t max_colors, const WsmeansOptions& options,
+                     FlatQuantizerResult* result) {
+  QuantizeWsmeans(PixelView(input_pixels), starting_clusters, max_colors,
+                  options, result);
+}
+
+void QuantizeWsmeans(const PixelView& input_pixels,
+                     const std::vector<Argb>& starting_clusters,
+                     uint16_t max_colors, const WsmeansOptions& options,
+                     FlatQuantizerResult* result, WsmeansWorkspace* workspace,
+                     WsmeansStats* stats) {
+  auto start = std::chrono::steady_clock::now();
+  if (max_colors == 0 || input_pixels.pixel_count() == 0) {
+    result->Clear();
+    if (stats != nullptr) {
+      *stats = WsmeansStats();
+    }
+    return;
   }
 
-  return {color_to_count, input_pixel_to_cluster_pixel};
+  WsmeansWorkspace local_workspace;
+  if (workspace == nullptr) {
+    workspace = &local_workspace;
+  }
+  WsmeansBuffers& buffers = *workspace->buffers_;
+  std::vector<Argb>& pixels = buffers.pixels;
+  std::vector<double>& point_weights = buffers.point_weights;
+  pixels.clear();
+  point_weights.clear();
+  buffers.color_indices.Clear();
+  ForEachPixel(input_pixels, [&](Argb pixel) {
+    size_t index = buffers.color_indices.FindOrInsert(pixel, pixels);
+    if (index == point_weights.size()) {
+      point_weights.push_back(1.0);
+    } else {
+      point_weights[index] += 1.0;
+    }
+  });
+  QuantizeColors(starting_clusters, max_colors, options, start, buffers,
+                 result, stats);
+}
+
+void QuantizeWsmeans(absl::Span<const WeightedColor> colors,
+                     const std::vector<Argb>& starting_clusters,
+                     uint16_t max_colors, const WsmeansOptions& options,
+                     FlatQuantizerResult* result, WsmeansWorkspace* workspace,
+                     WsmeansStats* stats) {
+  auto start = std::chrono::steady_clock::now();
+  WsmeansWorkspace local_workspace;
+  if (workspace == nullptr) {
+    workspace = &local_workspace;
+  }
+  WsmeansBuffers& buffers = *workspace->buffers_;
+  std::vector<Argb>& pixels = buffers.pixels;
+  std::vector<double>& point_weights = buffers.point_weights;
+  pixels.clear();
+  point_weights.clear();
+  for (const WeightedColor& color : colors) {
+    if (color.weight > 0) {
+      pixels.push_back(color.argb);
+      point_weights.push_back(color.weight);
+    }
+  }
+  QuantizeColors(starting_clusters, max_colors, options, start, buffers,
+                 result, stats);
+  // The swatches are left sorted by color, parallel to the palette.
+  for (size_t i = 0; i < result->colors.size(); i++) {
+    result->weights.push_back(buffers.swatches[i].weight);
+  }
+}
+
+QuantizerResult QuantizeWsmeans(const std::vector<Argb>& input_pixels,
+                                const std::vector<Argb>& starting_clusters,
+                                uint16_t max_colors,
+                                const WsmeansOptions& options) {
+  FlatQuantizerResult result;
+  QuantizeWsmeans(input_pixels, starting_clusters, max_colors, options,
+                  &result);
+  return ToQuantizerResult(result);
+}
+
+QuantizerResult ToQuantizerResult(const FlatQuantizerResult& result) {
+  // Both arrays are sorted, so each insertion is hinted at the end of the map
+  // and takes amortized constant time.
+  QuantizerResult legacy;
+  legacy.converged = result.converged;
+  for (size_t i = 0; i < result.colors.size(); i++) {
+    legacy.color_to_count.emplace_hint(legacy.color_to_count.end(),
+                                       result.colors[i],
+                                       result.populations[i]);
+  }
+  for (size_t i = 0; i < result.input_pixels.size(); i++) {
+    legacy.input_pixel_to_cluster_pixel.emplace_hint(
+        legacy.input_pixel_to_cluster_pixel.end(), result.input_pixels[i],
+        result.colors[result.cluster_indices[i]]);
+  }
+  return legacy;
 }
 
 }  // namespace material_color_utilities
@@ -18,21 +18,287 @@
 #define CPP_QUANTIZE_WSMEANS_H_
 #include <stdint.h>
 
+#include <chrono>
 #include <map>
+#include <memory>
 #include <vector>
 
+#include "absl/types/span.h"
+#include "cpp/quantize/pixel_view.h"
 #include "cpp/utils/utils.h"
 
 namespace material_color_utilities {
 
+/**
+ * `converged`: false if an iterative quantizer stopped at its iteration,
+ *              time or distance budget before its clusters settled; the
+ *              clusters are then the best found so far.
+ */
 struct QuantizerResult {
   std::map<Argb, uint32_t> color_to_count;
   std::map<Argb, Argb> input_pixel_to_cluster_pixel;
+  bool converged = true;
+};
+
+/**
+ * The same contents as QuantizerResult, held in sorted contiguous arrays
+ * instead of maps.
+ * `colors`: the palette, in ascending order.
+ * `populations`: the number of input pixels represented by each palette
+ *                color; parallel to `colors`.
+ * `weights`: the exact total weight of each palette color, for quantizers
+ *            given weighted colors rather than pixels; parallel to `colors`.
+ *            Empty for pixel inputs, where `populations` is exact.
+ * `input_pixels`: every distinct input color, in ascending order.
+ * `cluster_indices`: the index into `colors` of the palette color each input
+ *                    color was assigned to; parallel to `input_pixels`.
+ * `converged`: as in QuantizerResult.
+ *
+ * Quantizers clear, rather than free, these arrays, so a result reused across
+ * calls keeps its capacity and stops allocating once large enough.
+ */
+struct FlatQuantizerResult {
+  std::vector<Argb> colors;
+  std::vector<uint32_t> populations;
+  std::vector<double> weights;
+  std::vector<Argb> input_pixels;
+  std::vector<uint8_t> cluster_indices;
+  bool converged = true;
+
+  void Clear() {
+    colors.clear();
+    populations.clear();
+    weights.clear();
+    input_pixels.clear();
+    cluster_indices.clear();
+    converged = true;
+  }
+};
+
+/**
+ * Converts a FlatQuantizerResult to the equivalent QuantizerResult in time
+ * linear in its size.
+ */
+QuantizerResult ToQuantizerResult(const FlatQuantizerResult& result);
+
+/**
+ * Arithmetic used by QuantizeWsmeans.
+ * `kCompat`: double precision; points are within 1e-10 of the reference
+ *            implementation's L*a*b* values, so cluster assignments differ
+ *            from it only at exact ties.
+ * `kFast`: single precision when reassigning points to clusters; twice the
+ *          SIMD width, assignments may differ where two clusters are nearly
+ *          equidistant from a point.
+ * `kFloat32`: single precision throughout: points, cluster centers and the
+ *             sums that update them are floats, halving the memory per
+ *             distinct color as well as doubling the SIMD width. Populations
+ *             stay exact. Palettes differ from kCompat's only by small
+ *             shifts, which is ample for picking seed colors.
+ */
+enum class WsmeansPrecision {
+  kCompat,
+  kFast,
+  kFloat32,
+};
+
+/**
+ * How QuantizeWsmeans avoids distance computations when reassigning points.
+ * `kTriangleInequality`: computes the distance from every point to every
+ *                        cluster each iteration.
+ * `kHamerly`: keeps, for each point, an upper bound on the distance to its
+ *             cluster and a lower bound on the distance to any other,
+ *             loosened each iteration by how far clusters moved. Points whose
+ *             bounds show they cannot move are skipped without computing
+ *             distances. The clustering is the same as kTriangleInequality's.
+ */
+enum class WsmeansAcceleration {
+  kTriangleInequality,
+  kHamerly,
+};
+
+/**
+ * How QuantizeWsmeans merges similar input colors before clustering, which
+ * bounds the number of points for photographs with many distinct colors.
+ * `kNone`: every distinct color is a point.
+ * `kRgb666`: colors that agree in the top 6 bits of each channel are merged
+ *            into one point, at most 262144.
+ * `kRgb565`: colors that agree in the top 5 bits of red and blue and 6 of
+ *            green are merged into one point, at most 65536.
+ *
+ * A merged point is the weighted mean of its colors and carries their total
+ * weight, so populations are unchanged and cluster centers move only by
+ * rounding. Every distinct input color is still listed in the result, in the
+ * cluster of the point it was merged into.
+ */
+enum class WsmeansBucketing {
+  kNone,
+  kRgb666,
+  kRgb565,
+};
+
+/**
+ * Options for QuantizeWsmeans.
+ * `precision`: arithmetic used by the point reassignment kernel.
+ * `acceleration`: how distance computations are avoided.
+ * `bucketing`: how similar colors are merged before clustering.
+ * `num_threads`: maximum number of threads used to reassign points and
+ *                recompute cluster centers. The result is identical for any
+ *                thread count.
+ * `seed`: seeds the generator that places random starting clusters and
+ *         initially assigns points to clusters. Each call uses its own
+ *         generator, so concurrent calls are safe and reproducible.
+ * `max_iterations`: the most reassignment passes run; at least 1.
+ * `min_delta_e`: a point moves to a nearer cluster only if it is more than
+ *                this much closer in L*a*b* than its own. Clustering has
+ *                converged once no point moves.
+ * `time_budget`: if positive, no pass starts after this much time has
+ *                passed since the call began.
+ * `distance_budget`: if positive, no pass starts after this many distances
+ *                    from a point to a cluster have been computed.
+ *
+ * Budgets are checked between passes, so a call overruns them by at most
+ * one pass. A call that stops before converging returns the clusters found
+ * so far and clears the result's `converged`.
+ */
+struct WsmeansOptions {
+  WsmeansPrecision precision = WsmeansPrecision::kCompat;
+  WsmeansAcceleration acceleration = WsmeansAcceleration::kTriangleInequality;
+  WsmeansBucketing bucketing = WsmeansBucketing::kNone;
+  int num_threads = 1;
+  uint32_t seed = 42688;
+  int max_iterations = 100;
+  double min_delta_e = 3.0;
+  std::chrono::nanoseconds time_budget{0};
+  int64_t distance_budget = 0;
 };
 
 QuantizerResult QuantizeWsmeans(const std::vector<Argb>& input_pixels,
                                 const std::vector<Argb>& starting_clusters,
-                                uint16_t max_colors);
+                                uint16_t max_colors,
+                                const WsmeansOptions& options = {});
+
+/**
+ * Variant of QuantizeWsmeans that writes its result to sorted arrays,
+ * reusing the storage already held by `result`.
+ */
+void QuantizeWsmeans(const std::vector<Argb>& input_pixels,
+                     const std::vector<Argb>& starting_clusters,
+                     uint16_t max_colors, const WsmeansOptions& options,
+                     FlatQuantizerResult* result);
+
+class WsmeansWorkspace;
+
+/**
+ * How a call to QuantizeWsmeans converged, for finding out why an image is
+ * slow and for tuning.
+ * `distinct_colors`: distinct input colors.
+ * `points`: points clustered; fewer than `distinct_colors` only with
+ *           bucketing.
+ * `clusters`: clusters started from. The palette has fewer colors only if
+ *             some clusters were left empty or ended on the same color.
+ * `iterations`: reassignment passes run, including a final one in which no
+ *               point moved.
+ * `points_moved`: for each pass, the number of distinct colors that changed
+ *                 clusters.
+ * `distances_computed`: distances from a color to a cluster computed.
+ * `distances_skipped`: distances not computed because a color's bounds
+ *                      showed it could not move; always 0 without
+ *                      WsmeansAcceleration::kHamerly.
+ * `comparisons_skipped`: clusters the triangle inequality ruled out as
+ *                        nearer without comparing their distance.
+ */
+struct WsmeansStats {
+  int64_t distinct_colors = 0;
+  int64_t points = 0;
+  int clusters = 0;
+  int iterations = 0;
+  std::vector<int64_t> points_moved;
+  int64_t distances_computed = 0;
+  int64_t distances_skipped = 0;
+  int64_t comparisons_skipped = 0;
+};
+
+/**
+ * Variant of QuantizeWsmeans that reads pixels in place from a caller-owned
+ * image.
+ *
+ * @param workspace If given, holds storage between calls, so that repeated
+ *                  calls stop allocating. May be null.
+ * @param stats If given, filled in with how the clustering converged. May be
+ *              null, in which case nothing is counted.
+ */
+void QuantizeWsmeans(const PixelView& input_pixels,
+                     const std::vector<Argb>& starting_clusters,
+                     uint16_t max_colors, const WsmeansOptions& options,
+                     FlatQuantizerResult* result,
+                     WsmeansWorkspace* workspace = nullptr,
+                     WsmeansStats* stats = nullptr);
+
+/**
+ * A color and how much it counts towards the clustering, e.g. its pixel
+ * count, or a fractional saliency weight.
+ */
+struct WeightedColor {
+  Argb argb = 0;
+  double weight = 0.0;
+};
+
+/**
+ * Variant of QuantizeWsmeans that clusters an existing histogram instead of
+ * counting pixels. Colors should be distinct; colors with a weight of zero
+ * or less are ignored. Each cluster's exact total weight is written to
+ * `result->weights`. Its population treats the weights as pixel counts: the
+ * total weight rounded to the nearest integer, but at least 1, so weights
+ * normalized to sum to 1 give every cluster a population of 1. Callers
+ * ranking such a palette should use `weights`, e.g. with the weighted
+ * RankedSuggestions.
+ *
+ * With whole-number weights listed in the order colors first appear, the
+ * result is the same as for the pixels the histogram was counted from.
+ */
+void QuantizeWsmeans(absl::Span<const WeightedColor> colors,
+                     const std::vector<Argb>& starting_clusters,
+                     uint16_t max_colors, const WsmeansOptions& options,
+                     FlatQuantizerResult* result,
+                     WsmeansWorkspace* workspace = nullptr,
+                     WsmeansStats* stats = nullptr);
+
+struct WsmeansBuffers;
+
+/**
+ * Storage used by QuantizeWsmeans, owned by the caller and reused across
+ * calls: the color table, points, cluster distances and per-block partial
+ * sums keep their capacity, so quantizing many similar images allocates only
+ * for the first.
+ *
+ * A workspace must not be used by two calls at once.
+ */
+class WsmeansWorkspace {
+ public:
+  WsmeansWorkspace();
+  ~WsmeansWorkspace();
+  WsmeansWorkspace(WsmeansWorkspace&&);
+  WsmeansWorkspace& operator=(WsmeansWorkspace&&);
+
+ private:
+  std::unique_ptr<WsmeansBuffers> buffers_;
+
+  friend void QuantizeWsmeans(const PixelView& input_pixels,
+                              const std::vector<Argb>& starting_clusters,
+                              uint16_t max_colors,
+                              const WsmeansOptions& options,
+                              FlatQuantizerResult* result,
+                              WsmeansWorkspace* workspace,
+                              WsmeansStats* stats);
+  friend void QuantizeWsmeans(absl::Span<const WeightedColor> colors,
+                              const std::vector<Argb>& starting_clusters,
+                              uint16_t max_colors,
+                              const WsmeansOptions& options,
+                              FlatQuantizerResult* result,
+                              WsmeansWorkspace* workspace,
+                              WsmeansStats* stats);
+};
+
 }  // namespace material_color_utilities
 
 #endif  // CPP_QUANTIZE_WSMEANS_H_
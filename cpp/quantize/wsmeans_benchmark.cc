@@ -0,0 +1,235 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "testing/base/public/benchmark.h"
+#include "cpp/quantize/lab.h"
+#include "cpp/quantize/lab_distance.h"
+#include "cpp/quantize/pixel_view.h"
+#include "cpp/quantize/synthetic_images.h"
+#include "cpp/quantize/wsmeans.h"
+#include "cpp/quantize/wu.h"
+#include "cpp/utils/utils.h"
+
+namespace material_color_utilities {
+
+namespace {
+
+std::vector<Argb> RandomPixels(int count, int distinct_colors) {
+  srand(42688);
+  std::vector<Argb> palette;
+  for (int i = 0; i < distinct_colors; i++) {
+    palette.push_back(0xff000000 | (rand() & 0xffffff));
+  }
+  std::vector<Argb> pixels;
+  for (int i = 0; i < count; i++) {
+    pixels.push_back(palette[rand() % distinct_colors]);
+  }
+  return pixels;
+}
+
+// The scalar level is the reference implementation the SIMD kernels are
+// compared against.
+template <typename T>
+void BM_SquaredLabDistances(benchmark::State& state) {
+  SimdLevel level = static_cast<SimdLevel>(state.range(0));
+  int cluster_count = state.range(1);
+  LabArrays<T> clusters;
+  clusters.Resize(cluster_count);
+  std::vector<Argb> colors = RandomPixels(cluster_count, cluster_count);
+  for (int i = 0; i < cluster_count; i++) {
+    clusters.Set(i, LabFromInt(colors[i]));
+  }
+  std::vector<T> distances(cluster_count);
+  Lab point = LabFromInt(0xff336699);
+  for (auto s : state) {
+    SquaredLabDistances(level, point, clusters, distances.data());
+    benchmark::DoNotOptimize(distances.data());
+  }
+  state.SetLabel(SimdLevelName(level));
+  state.SetItemsProcessed(state.iterations() * cluster_count);
+}
+BENCHMARK_TEMPLATE(BM_SquaredLabDistances, double)
+    ->ArgsProduct({{static_cast<int>(SimdLevel::kScalar),
+                    static_cast<int>(SimdLevel::kSse42),
+                    static_cast<int>(SimdLevel::kAvx2)},
+                   {16, 128, 256}});
+BENCHMARK_TEMPLATE(BM_SquaredLabDistances, float)
+    ->ArgsProduct({{static_cast<int>(SimdLevel::kScalar),
+                    static_cast<int>(SimdLevel::kSse42),
+                    static_cast<int>(SimdLevel::kAvx2)},
+                   {16, 128, 256}});
+
+void BM_QuantizeWsmeans(benchmark::State& state) {
+  WsmeansOptions options;
+  options.precision = static_cast<WsmeansPrecision>(state.range(0));
+  std::vector<Argb> pixels = RandomPixels(112 * 112, 8000);
+  std::vector<Argb> starting_clusters;
+  for (auto s : state) {
+    benchmark::DoNotOptimize(
+        QuantizeWsmeans(pixels, starting_clusters, 128, options));
+  }
+  const char* labels[] = {"compat", "fast", "float32"};
+  state.SetLabel(labels[state.range(0)]);
+}
+BENCHMARK(BM_QuantizeWsmeans)
+    ->Arg(static_cast<int>(WsmeansPrecision::kCompat))
+    ->Arg(static_cast<int>(WsmeansPrecision::kFast))
+    ->Arg(static_cast<int>(WsmeansPrecision::kFloat32));
+
+void BM_QuantizeWsmeansThreads(benchmark::State& state) {
+  WsmeansOptions options;
+  options.num_threads = state.range(0);
+  // A 512x512 photo-like input with many distinct colors.
+  std::vector<Argb> pixels = RandomPixels(512 * 512, 100000);
+  std::vector<Argb> starting_clusters;
+  for (auto s : state) {
+    benchmark::DoNotOptimize(
+        QuantizeWsmeans(pixels, starting_clusters, 128, options));
+  }
+}
+BENCHMARK(BM_QuantizeWsmeansThreads)
+    ->DenseRange(1, std::max(1u, std::thread::hardware_concurrency()))
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// Random starting clusters take many iterations to settle, which is where
+// bounds carried across iterations save the most; Wu starting clusters, as
+// in QuantizeCelebi, converge in a few.
+void BM_QuantizeWsmeansAcceleration(benchmark::State& state) {
+  WsmeansOptions options;
+  options.acceleration = static_cast<WsmeansAcceleration>(state.range(0));
+  int max_colors = state.range(1);
+  bool wu_start = state.range(2);
+  std::vector<Argb> pixels = SyntheticImageCorpus(256, 256)[0].pixels;
+  std::vector<Argb> starting_clusters;
+  if (wu_start) {
+    starting_clusters = QuantizeWu(pixels, max_colors);
+  }
+  for (auto s : state) {
+    benchmark::DoNotOptimize(
+        QuantizeWsmeans(pixels, starting_clusters, max_colors, options));
+  }
+  state.SetLabel(std::string(options.acceleration ==
+                                     WsmeansAcceleration::kHamerly
+                                 ? "hamerly"
+                                 : "triangle") +
+                 (wu_start ? "/wu_start" : "/random_start"));
+}
+BENCHMARK(BM_QuantizeWsmeansAcceleration)
+    ->ArgsProduct({{static_cast<int>(WsmeansAcceleration::kTriangleInequality),
+                    static_cast<int>(WsmeansAcceleration::kHamerly)},
+                   {16, 128, 256},
+                   {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+
+// Argument: whether to collect WsmeansStats. Collecting them should cost
+// close to nothing; the counters are reported for the Wu-started case.
+void BM_QuantizeWsmeansStats(benchmark::State& state) {
+  bool collect_stats = state.range(0);
+  std::vector<Argb> pixels = SyntheticImageCorpus(256, 256)[0].pixels;
+  std::vector<Argb> starting_clusters = QuantizeWu(pixels, 128);
+  FlatQuantizerResult result;
+  WsmeansStats stats;
+  for (auto s : state) {
+    QuantizeWsmeans(PixelView(pixels), starting_clusters, 128,
+                    WsmeansOptions(), &result, nullptr,
+                    collect_stats ? &stats : nullptr);
+    benchmark::DoNotOptimize(result.colors.data());
+  }
+  if (collect_stats) {
+    state.counters["iterations"] = stats.iterations;
+    state.counters["first_points_moved"] = stats.points_moved[0];
+    state.counters["distances_computed"] = stats.distances_computed;
+    state.counters["comparisons_skipped"] = stats.comparisons_skipped;
+  }
+}
+BENCHMARK(BM_QuantizeWsmeansStats)->Arg(0)->Arg(1)->Unit(
+    benchmark::kMillisecond);
+
+/**
+ * Returns the mean L*a*b* distance from each pixel to the palette color its
+ * color was assigned to.
+ */
+double QuantizationError(const std::vector<Argb>& pixels,
+                         const FlatQuantizerResult& result) {
+  double distance_sum = 0.0;
+  for (Argb pixel : pixels) {
+    size_t index = std::lower_bound(result.input_pixels.begin(),
+                                    result.input_pixels.end(), pixel) -
+                   result.input_pixels.begin();
+    Argb color = result.colors[result.cluster_indices[index]];
+    distance_sum += std::sqrt(LabFromInt(pixel).DeltaE(LabFromInt(color)));
+  }
+  return distance_sum / pixels.size();
+}
+
+// Argument: WsmeansBucketing. Clusters each 512x512 image of the synthetic
+// corpus from Wu starting clusters, as QuantizeCelebi does, and reports, as
+// means over the corpus:
+// `distinct_colors`, `points`: as in WsmeansStats.
+// `quantization_error`: mean distance in L*a*b* from a pixel to its palette
+//                       color.
+void BM_QuantizeWsmeansBucketing(benchmark::State& state) {
+  WsmeansOptions options;
+  options.bucketing = static_cast<WsmeansBucketing>(state.range(0));
+  std::vector<SyntheticImage> corpus = SyntheticImageCorpus(512, 512);
+  std::vector<std::vector<Argb>> starting_clusters;
+  for (const SyntheticImage& image : corpus) {
+    starting_clusters.push_back(QuantizeWu(image.pixels, 128));
+  }
+  WsmeansWorkspace workspace;
+  FlatQuantizerResult result;
+  for (auto s : state) {
+    for (size_t i = 0; i < corpus.size(); i++) {
+      QuantizeWsmeans(PixelView(corpus[i].pixels), starting_clusters[i], 128,
+                      options, &result, &workspace);
+      benchmark::DoNotOptimize(result.colors.data());
+    }
+  }
+
+  double distinct_colors = 0.0;
+  double points = 0.0;
+  double error = 0.0;
+  for (size_t i = 0; i < corpus.size(); i++) {
+    WsmeansStats stats;
+    QuantizeWsmeans(PixelView(corpus[i].pixels), starting_clusters[i], 128,
+                    options, &result, &workspace, &stats);
+    distinct_colors += stats.distinct_colors;
+    points += stats.points;
+    error += QuantizationError(corpus[i].pixels, result);
+  }
+  state.counters["distinct_colors"] = distinct_colors / corpus.size();
+  state.counters["points"] = points / corpus.size();
+  state.counters["quantization_error"] = error / corpus.size();
+  const char* labels[] = {"none", "rgb666", "rgb565"};
+  state.SetLabel(labels[state.range(0)]);
+}
+BENCHMARK(BM_QuantizeWsmeansBucketing)
+    ->Arg(static_cast<int>(WsmeansBucketing::kNone))
+    ->Arg(static_cast<int>(WsmeansBucketing::kRgb666))
+    ->Arg(static_cast<int>(WsmeansBucketing::kRgb565))
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace material_color_utilities
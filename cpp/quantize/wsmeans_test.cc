@@ -16,9 +16,19 @@
 
 #include "cpp/quantize/wsmeans.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #include "testing/base/public/gunit.h"
+#include "cpp/quantize/lab.h"
+#include "cpp/quantize/pixel_view.h"
+#include "cpp/quantize/wu.h"
+#include "cpp/score/score.h"
 
 namespace material_color_utilities {
 
@@ -92,5 +102,501 @@ TEST(WsmeansTest, FiveBlue) {
   EXPECT_EQ(result.color_to_count[0xff0000ff], 5u);
 }
 
+TEST(WsmeansTest, FastPrecisionOneBlue) {
+  std::vector<Argb> pixels(5, 0xff0000ff);
+  std::vector<Argb> starting_clusters;
+  WsmeansOptions options;
+  options.precision = WsmeansPrecision::kFast;
+  QuantizerResult result =
+      QuantizeWsmeans(pixels, starting_clusters, 256, options);
+  EXPECT_EQ(result.color_to_count.size(), 1u);
+  EXPECT_EQ(result.color_to_count[0xff0000ff], 5u);
+}
+
+TEST(WsmeansTest, FastPrecisionMatchesCompatForDistinctColors) {
+  // Clusters far apart from each other, so float rounding cannot change which
+  // one is nearest.
+  std::vector<Argb> pixels;
+  for (Argb color : {0xffff0000, 0xff00ff00, 0xff0000ff, 0xffffff00}) {
+    for (int i = 0; i < 100; i++) {
+      pixels.push_back(color + (i % 4));
+    }
+  }
+  std::vector<Argb> starting_clusters = {0xffff0000, 0xff00ff00, 0xff0000ff,
+                                         0xffffff00};
+  WsmeansOptions options;
+  options.precision = WsmeansPrecision::kFast;
+  QuantizerResult fast =
+      QuantizeWsmeans(pixels, starting_clusters, 4, options);
+  QuantizerResult compat = QuantizeWsmeans(pixels, starting_clusters, 4);
+  EXPECT_EQ(fast.color_to_count, compat.color_to_count);
+  EXPECT_EQ(fast.input_pixel_to_cluster_pixel,
+            compat.input_pixel_to_cluster_pixel);
+}
+
+TEST(WsmeansTest, Float32PrecisionStaysCloseToCompat) {
+  std::vector<Argb> pixels(40000);
+  for (size_t i = 0; i < pixels.size(); i++) {
+    pixels[i] = 0xff000000 | ((i * 2654435761u) & 0xffffff);
+  }
+  std::vector<Argb> starting_clusters = QuantizeWu(pixels, 64);
+  FlatQuantizerResult compat;
+  QuantizeWsmeans(PixelView(pixels), starting_clusters, 64, WsmeansOptions(),
+                  &compat);
+  WsmeansOptions options;
+  options.precision = WsmeansPrecision::kFloat32;
+  FlatQuantizerResult result;
+  QuantizeWsmeans(PixelView(pixels), starting_clusters, 64, options, &result);
+
+  ASSERT_EQ(result.input_pixels, compat.input_pixels);
+  uint64_t total = 0;
+  for (uint32_t population : result.populations) {
+    total += population;
+  }
+  EXPECT_EQ(total, pixels.size());
+  // Every color is near one of kCompat's.
+  for (Argb color : result.colors) {
+    Lab lab = LabFromInt(color);
+    double nearest = 1e9;
+    for (Argb compat_color : compat.colors) {
+      nearest = std::min(nearest, lab.DeltaE(LabFromInt(compat_color)));
+    }
+    EXPECT_LT(sqrt(nearest), 3.0) << std::hex << color;
+  }
+}
+
+TEST(WsmeansTest, ResultDoesNotDependOnThreadCount) {
+  // Enough distinct colors to span several blocks of points.
+  std::vector<Argb> pixels(40000);
+  for (size_t i = 0; i < pixels.size(); i++) {
+    pixels[i] = 0xff000000 | ((i * 2654435761u) & 0xffffff);
+  }
+  std::vector<Argb> starting_clusters;
+  QuantizerResult single_threaded =
+      QuantizeWsmeans(pixels, starting_clusters, 64);
+  for (int num_threads : {2, 3, 8}) {
+    WsmeansOptions options;
+    options.num_threads = num_threads;
+    QuantizerResult result =
+        QuantizeWsmeans(pixels, starting_clusters, 64, options);
+    EXPECT_EQ(result.color_to_count, single_threaded.color_to_count);
+    EXPECT_EQ(result.input_pixel_to_cluster_pixel,
+              single_threaded.input_pixel_to_cluster_pixel);
+  }
+}
+
+TEST(WsmeansTest, HamerlyAccelerationMatchesTriangleInequality) {
+  std::vector<Argb> pixels(20000);
+  for (size_t i = 0; i < pixels.size(); i++) {
+    pixels[i] = 0xff000000 | ((i * 2654435761u) & 0xffffff);
+  }
+  std::vector<Argb> starting_clusters;
+  for (WsmeansPrecision precision :
+       {WsmeansPrecision::kCompat, WsmeansPrecision::kFast,
+        WsmeansPrecision::kFloat32}) {
+    for (int max_colors : {16, 128, 256}) {
+      WsmeansOptions options;
+      options.precision = precision;
+      QuantizerResult expected =
+          QuantizeWsmeans(pixels, starting_clusters, max_colors, options);
+      options.acceleration = WsmeansAcceleration::kHamerly;
+      QuantizerResult result =
+          QuantizeWsmeans(pixels, starting_clusters, max_colors, options);
+      EXPECT_EQ(result.color_to_count, expected.color_to_count);
+      EXPECT_EQ(result.input_pixel_to_cluster_pixel,
+                expected.input_pixel_to_cluster_pixel);
+    }
+  }
+}
+
+TEST(WsmeansTest, StatsDescribeConvergence) {
+  std::vector<Argb> pixels(20000);
+  for (size_t i = 0; i < pixels.size(); i++) {
+    pixels[i] = 0xff000000 | ((i * 2654435761u) & 0xffffff);
+  }
+  const int max_colors = 64;
+  WsmeansOptions options;
+  FlatQuantizerResult expected;
+  QuantizeWsmeans(pixels, {}, max_colors, options, &expected);
+
+  FlatQuantizerResult result;
+  WsmeansStats stats;
+  QuantizeWsmeans(PixelView(pixels), {}, max_colors, options, &result,
+                  nullptr, &stats);
+  // Counting does not change the clustering.
+  EXPECT_EQ(result.colors, expected.colors);
+  EXPECT_EQ(result.cluster_indices, expected.cluster_indices);
+
+  ASSERT_GT(stats.iterations, 1);
+  ASSERT_EQ(stats.points_moved.size(), static_cast<size_t>(stats.iterations));
+  EXPECT_GT(stats.points_moved[0], 0);
+  // The last pass either moved nothing or hit the iteration cap.
+  EXPECT_TRUE(stats.points_moved.back() == 0 || stats.iterations == 100)
+      << stats.iterations;
+  // Every pass computes every distance.
+  EXPECT_EQ(stats.distances_computed,
+            static_cast<int64_t>(stats.iterations) * pixels.size() *
+                max_colors);
+  EXPECT_EQ(stats.distances_skipped, 0);
+  EXPECT_GT(stats.comparisons_skipped, 0);
+
+  options.acceleration = WsmeansAcceleration::kHamerly;
+  WsmeansStats hamerly_stats;
+  QuantizeWsmeans(PixelView(pixels), {}, max_colors, options, &result,
+                  nullptr, &hamerly_stats);
+  EXPECT_EQ(result.colors, expected.colors);
+  EXPECT_EQ(hamerly_stats.iterations, stats.iterations);
+  EXPECT_EQ(hamerly_stats.points_moved, stats.points_moved);
+  EXPECT_GT(hamerly_stats.distances_skipped, 0);
+  EXPECT_LT(hamerly_stats.distances_computed, stats.distances_computed);
+
+  // Stats are reset by each call.
+  QuantizeWsmeans(PixelView(pixels), {}, max_colors, options, &result,
+                  nullptr, &hamerly_stats);
+  EXPECT_EQ(hamerly_stats.points_moved, stats.points_moved);
+
+  // Starting from Wu's palette, as QuantizeCelebi does, converges well
+  // before the cap.
+  QuantizeWsmeans(PixelView(pixels), QuantizeWu(pixels, max_colors),
+                  max_colors, options, &result, nullptr, &stats);
+  EXPECT_LT(stats.iterations, 100);
+  EXPECT_EQ(stats.points_moved.back(), 0);
+}
+
+TEST(WsmeansTest, BudgetsStopBeforeConvergence) {
+  std::vector<Argb> pixels(20000);
+  for (size_t i = 0; i < pixels.size(); i++) {
+    pixels[i] = 0xff000000 | ((i * 2654435761u) & 0xffffff);
+  }
+  std::vector<Argb> starting_clusters = QuantizeWu(pixels, 64);
+  FlatQuantizerResult result;
+  WsmeansStats stats;
+
+  WsmeansOptions options;
+  QuantizeWsmeans(PixelView(pixels), starting_clusters, 64, options, &result,
+                  nullptr, &stats);
+  EXPECT_TRUE(result.converged);
+  int converged_iterations = stats.iterations;
+  ASSERT_GT(converged_iterations, 2);
+
+  options.max_iterations = 2;
+  QuantizeWsmeans(PixelView(pixels), starting_clusters, 64, options, &result,
+                  nullptr, &stats);
+  EXPECT_FALSE(result.converged);
+  EXPECT_EQ(stats.iterations, 2);
+  EXPECT_FALSE(result.colors.empty());
+
+  // Each budget lets one pass run.
+  options = WsmeansOptions();
+  options.distance_budget = 1;
+  QuantizeWsmeans(PixelView(pixels), starting_clusters, 64, options, &result,
+                  nullptr, &stats);
+  EXPECT_FALSE(result.converged);
+  EXPECT_EQ(stats.iterations, 1);
+
+  options = WsmeansOptions();
+  options.time_budget = std::chrono::nanoseconds(1);
+  QuantizeWsmeans(PixelView(pixels), starting_clusters, 64, options, &result,
+                  nullptr, &stats);
+  EXPECT_FALSE(result.converged);
+  EXPECT_EQ(stats.iterations, 1);
+  EXPECT_FALSE(ToQuantizerResult(result).converged);
+
+  // A generous budget changes nothing.
+  options = WsmeansOptions();
+  options.max_iterations = converged_iterations;
+  options.distance_budget = int64_t{1} << 40;
+  options.time_budget = std::chrono::hours(1);
+  QuantizeWsmeans(PixelView(pixels), starting_clusters, 64, options, &result,
+                  nullptr, &stats);
+  EXPECT_TRUE(result.converged);
+  EXPECT_EQ(stats.iterations, converged_iterations);
+}
+
+TEST(WsmeansTest, MinDeltaEControlsMoves) {
+  std::vector<Argb> pixels(5000);
+  for (size_t i = 0; i < pixels.size(); i++) {
+    pixels[i] = 0xff000000 | ((i * 2654435761u) & 0xffffff);
+  }
+  FlatQuantizerResult result;
+  WsmeansStats stats;
+  WsmeansOptions options;
+  // No cluster is ever far enough closer, so nothing moves and the second
+  // pass finds the clustering settled.
+  options.min_delta_e = 1000.0;
+  QuantizeWsmeans(PixelView(pixels), QuantizeWu(pixels, 16), 16, options,
+                  &result, nullptr, &stats);
+  EXPECT_TRUE(result.converged);
+  EXPECT_EQ(stats.iterations, 2);
+  EXPECT_EQ(stats.points_moved, std::vector<int64_t>({0, 0}));
+}
+
+TEST(WsmeansTest, ConcurrentCallsMatchSequentialCalls) {
+  constexpr int kInputCount = 6;
+  constexpr int kThreadCount = 8;
+  std::vector<std::vector<Argb>> inputs(kInputCount);
+  for (int input = 0; input < kInputCount; input++) {
+    for (uint32_t i = 0; i < 3000; i++) {
+      inputs[input].push_back(0xff000000 |
+                              (((i + input * 7919) * 2654435761u) & 0xffffff));
+    }
+  }
+  // Without starting clusters, every cluster is placed randomly.
+  std::vector<Argb> starting_clusters;
+  std::vector<QuantizerResult> expected;
+  for (const std::vector<Argb>& pixels : inputs) {
+    expected.push_back(QuantizeWsmeans(pixels, starting_clusters, 32));
+  }
+
+  std::vector<std::vector<QuantizerResult>> results(kThreadCount);
+  std::vector<std::thread> threads;
+  for (int thread = 0; thread < kThreadCount; thread++) {
+    threads.emplace_back([&, thread] {
+      for (int round = 0; round < 3; round++) {
+        for (int input = 0; input < kInputCount; input++) {
+          results[thread].push_back(QuantizeWsmeans(
+              inputs[(input + thread) % kInputCount], starting_clusters, 32));
+        }
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  for (int thread = 0; thread < kThreadCount; thread++) {
+    for (size_t call = 0; call < results[thread].size(); call++) {
+      const QuantizerResult& want =
+          expected[(call % kInputCount + thread) % kInputCount];
+      EXPECT_EQ(results[thread][call].color_to_count, want.color_to_count);
+      EXPECT_EQ(results[thread][call].input_pixel_to_cluster_pixel,
+                want.input_pixel_to_cluster_pixel);
+    }
+  }
+}
+
+TEST(WsmeansTest, RgbaViewMatchesArgbPixels) {
+  std::vector<Argb> pixels(3000);
+  for (size_t i = 0; i < pixels.size(); i++) {
+    pixels[i] = 0xff000000 | (((i % 700) * 2654435761u) & 0xffffff);
+  }
+  std::vector<uint8_t> rgba;
+  for (Argb argb : pixels) {
+    rgba.push_back((argb >> 16) & 0xff);
+    rgba.push_back((argb >> 8) & 0xff);
+    rgba.push_back(argb & 0xff);
+    rgba.push_back(argb >> 24);
+  }
+  PixelView view(rgba.data(), 60, 50, 60 * 4, PixelFormat::kRgba8888);
+  std::vector<Argb> starting_clusters = {0xffff0000, 0xff00ff00, 0xff0000ff};
+  FlatQuantizerResult expected;
+  QuantizeWsmeans(pixels, starting_clusters, 3, {}, &expected);
+  FlatQuantizerResult result;
+  QuantizeWsmeans(view, starting_clusters, 3, {}, &result);
+  EXPECT_EQ(result.colors, expected.colors);
+  EXPECT_EQ(result.populations, expected.populations);
+  EXPECT_EQ(result.input_pixels, expected.input_pixels);
+  EXPECT_EQ(result.cluster_indices, expected.cluster_indices);
+}
+
+TEST(WsmeansTest, FullyTransparentViewGivesEmptyResult) {
+  std::vector<Argb> pixels = {0x00ff0000, 0x7f00ff00};
+  PixelView view(pixels);
+  view.opaque_only = true;
+  FlatQuantizerResult result;
+  QuantizeWsmeans(view, {}, 16, {}, &result);
+  EXPECT_TRUE(result.colors.empty());
+  EXPECT_TRUE(result.input_pixels.empty());
+}
+
+TEST(WsmeansTest, WeightedColorsMatchPixels) {
+  std::vector<Argb> pixels;
+  std::vector<WeightedColor> colors;
+  for (uint32_t i = 0; i < 500; i++) {
+    Argb argb = 0xff000000 | ((i * 2654435761u) & 0xffffff);
+    int count = 1 + i % 7;
+    colors.push_back({argb, static_cast<double>(count)});
+    for (int j = 0; j < count; j++) {
+      pixels.push_back(argb);
+    }
+  }
+  std::vector<Argb> starting_clusters;
+  FlatQuantizerResult expected;
+  QuantizeWsmeans(pixels, starting_clusters, 32, {}, &expected);
+  FlatQuantizerResult result;
+  QuantizeWsmeans(colors, starting_clusters, 32, {}, &result);
+  EXPECT_EQ(result.colors, expected.colors);
+  EXPECT_EQ(result.populations, expected.populations);
+  EXPECT_EQ(result.input_pixels, expected.input_pixels);
+  EXPECT_EQ(result.cluster_indices, expected.cluster_indices);
+}
+
+TEST(WsmeansTest, FractionalWeightsPullCenters) {
+  // A single cluster lands on the weighted mean of its colors.
+  std::vector<WeightedColor> colors = {{0xff000000, 0.25},
+                                       {0xffffffff, 0.25},
+                                       {0xff777777, 1.5},
+                                       {0xffff0000, 0.0}};
+  std::vector<Argb> starting_clusters = {0xff777777};
+  FlatQuantizerResult result;
+  QuantizeWsmeans(colors, starting_clusters, 1, {}, &result);
+  ASSERT_EQ(result.colors.size(), 1u);
+  Lab black = LabFromInt(0xff000000);
+  Lab white = LabFromInt(0xffffffff);
+  Lab gray = LabFromInt(0xff777777);
+  Lab mean = {(black.l * 0.25 + white.l * 0.25 + gray.l * 1.5) / 2.0,
+              (black.a * 0.25 + white.a * 0.25 + gray.a * 1.5) / 2.0,
+              (black.b * 0.25 + white.b * 0.25 + gray.b * 1.5) / 2.0};
+  EXPECT_EQ(result.colors[0], IntFromLab(mean));
+  EXPECT_EQ(result.populations[0], 2u);
+  // The zero-weight color is ignored.
+  EXPECT_EQ(result.input_pixels,
+            std::vector<Argb>({0xff000000, 0xff777777, 0xffffffff}));
+}
+
+TEST(WsmeansTest, NormalizedWeightsKeepPopulationsAndRanking) {
+  // Saliency weights that sum to 1 would round every population to 0.
+  std::vector<WeightedColor> counts;
+  std::vector<WeightedColor> normalized;
+  for (uint32_t i = 0; i < 2000; i++) {
+    Argb argb = 0xff000000 | ((i * 2654435761u) & 0xffffff);
+    counts.push_back({argb, 1.0});
+    normalized.push_back({argb, 1.0 / 2000});
+  }
+  std::vector<Argb> starting_clusters;
+  FlatQuantizerResult expected;
+  QuantizeWsmeans(counts, starting_clusters, 16, {}, &expected);
+  FlatQuantizerResult result;
+  QuantizeWsmeans(normalized, starting_clusters, 16, {}, &result);
+  ASSERT_EQ(result.weights.size(), result.colors.size());
+  double weight_sum = 0.0;
+  for (size_t i = 0; i < result.colors.size(); i++) {
+    EXPECT_GE(result.populations[i], 1u);
+    weight_sum += result.weights[i];
+  }
+  EXPECT_NEAR(weight_sum, 1.0, 1e-9);
+  EXPECT_EQ(RankedSuggestions(result.colors, result.weights),
+            RankedSuggestions(expected.colors, expected.populations));
+}
+
+TEST(WsmeansTest, PixelResultsHaveNoWeights) {
+  std::vector<Argb> pixels = {0xff0000ff, 0xffff0000, 0xff0000ff};
+  FlatQuantizerResult result;
+  QuantizeWsmeans(pixels, {}, 16, {}, &result);
+  EXPECT_FALSE(result.colors.empty());
+  EXPECT_TRUE(result.weights.empty());
+}
+
+TEST(WsmeansTest, FlatResultIsSorted) {
+  std::vector<Argb> pixels = {0xff0000ff, 0xffff0000, 0xff0000ff,
+                              0xff00ff00, 0xffff0000, 0xff0000ff};
+  std::vector<Argb> starting_clusters;
+  FlatQuantizerResult result;
+  QuantizeWsmeans(pixels, starting_clusters, 256, {}, &result);
+  EXPECT_EQ(result.colors,
+            (std::vector<Argb>{0xff0000ff, 0xff00ff00, 0xffff0000}));
+  EXPECT_EQ(result.populations, (std::vector<uint32_t>{3, 1, 2}));
+  EXPECT_EQ(result.input_pixels,
+            (std::vector<Argb>{0xff0000ff, 0xff00ff00, 0xffff0000}));
+  EXPECT_EQ(result.cluster_indices, (std::vector<uint8_t>{0, 1, 2}));
+}
+
+TEST(WsmeansTest, FlatResultAccountsForEveryPixel) {
+  std::vector<Argb> pixels(12544);
+  for (size_t i = 0; i < pixels.size(); i++) {
+    pixels[i] = 0xff000000 | (((i % 8000) * 2654435761u) & 0xffffff);
+  }
+  std::vector<Argb> starting_clusters;
+  FlatQuantizerResult result;
+  QuantizeWsmeans(pixels, starting_clusters, 32, {}, &result);
+
+  uint32_t population_sum = 0;
+  for (uint32_t population : result.populations) {
+    population_sum += population;
+  }
+  EXPECT_EQ(population_sum, pixels.size());
+  EXPECT_EQ(result.input_pixels.size(), 8000u);
+  EXPECT_TRUE(
+      std::is_sorted(result.input_pixels.begin(), result.input_pixels.end()));
+  for (uint8_t cluster_index : result.cluster_indices) {
+    EXPECT_LT(cluster_index, result.colors.size());
+  }
+}
+
+TEST(WsmeansTest, BucketingWithOneColorPerBucketMatchesNoBucketing) {
+  // Every color already lies on the 5-6-5 grid, so no two share a bucket.
+  std::vector<Argb> pixels(12544);
+  for (size_t i = 0; i < pixels.size(); i++) {
+    pixels[i] = 0xff000000 | (((i % 3000) * 2654435761u) & 0xf8fcf8);
+  }
+  std::vector<Argb> starting_clusters = QuantizeWu(pixels, 32);
+  FlatQuantizerResult expected;
+  QuantizeWsmeans(pixels, starting_clusters, 32, {}, &expected);
+  for (WsmeansBucketing bucketing :
+       {WsmeansBucketing::kRgb666, WsmeansBucketing::kRgb565}) {
+    WsmeansOptions options;
+    options.bucketing = bucketing;
+    FlatQuantizerResult result;
+    WsmeansStats stats;
+    QuantizeWsmeans(PixelView(pixels), starting_clusters, 32, options,
+                    &result, nullptr, &stats);
+    EXPECT_EQ(stats.points, stats.distinct_colors);
+    EXPECT_EQ(result.colors, expected.colors);
+    EXPECT_EQ(result.populations, expected.populations);
+    EXPECT_EQ(result.input_pixels, expected.input_pixels);
+    EXPECT_EQ(result.cluster_indices, expected.cluster_indices);
+  }
+}
+
+TEST(WsmeansTest, BucketingMergesSimilarColors) {
+  // The greys agree in their top 6 bits, the blue does not.
+  std::vector<Argb> pixels = {0xff404040, 0xff414243, 0xff414243,
+                              0xff414243, 0xff0000ff};
+  WsmeansOptions options;
+  options.bucketing = WsmeansBucketing::kRgb666;
+  FlatQuantizerResult result;
+  WsmeansStats stats;
+  QuantizeWsmeans(PixelView(pixels), {0xff404040, 0xff0000ff}, 256, options,
+                  &result, nullptr, &stats);
+  EXPECT_EQ(stats.distinct_colors, 3);
+  EXPECT_EQ(stats.points, 2);
+  ASSERT_EQ(result.colors.size(), 2u);
+  EXPECT_EQ(result.colors[0], 0xff0000ff);
+  EXPECT_EQ(result.populations, (std::vector<uint32_t>{1, 4}));
+  EXPECT_EQ(result.input_pixels,
+            (std::vector<Argb>{0xff0000ff, 0xff404040, 0xff414243}));
+  EXPECT_EQ(result.cluster_indices, (std::vector<uint8_t>{0, 1, 1}));
+}
+
+TEST(WsmeansTest, BucketingBoundsPointCount) {
+  // 65536 distinct colors whose blue follows red.
+  std::vector<Argb> pixels;
+  for (int red = 0; red < 256; red++) {
+    for (int green = 0; green < 256; green++) {
+      pixels.push_back(ArgbFromRgb(red, green, 255 - red));
+    }
+  }
+  for (auto [bucketing, points] :
+       {std::pair{WsmeansBucketing::kNone, 65536},
+        std::pair{WsmeansBucketing::kRgb666, 64 * 64},
+        std::pair{WsmeansBucketing::kRgb565, 32 * 64}}) {
+    WsmeansOptions options;
+    options.bucketing = bucketing;
+    FlatQuantizerResult result;
+    WsmeansStats stats;
+    QuantizeWsmeans(PixelView(pixels), QuantizeWu(pixels, 64), 64, options,
+                    &result, nullptr, &stats);
+    EXPECT_EQ(stats.distinct_colors, 65536);
+    EXPECT_EQ(stats.points, points);
+
+    uint32_t population_sum = 0;
+    for (uint32_t population : result.populations) {
+      population_sum += population;
+    }
+    EXPECT_EQ(population_sum, pixels.size());
+    EXPECT_EQ(result.input_pixels.size(), pixels.size());
+  }
+}
+
 }  // namespace
 }  // namespace material_color_utilities
@@ -18,11 +18,18 @@
 
 #include <stdlib.h>
 
+#include <algorithm>
+#include <array>
 #include <cassert>
 #include <cstdint>
 #include <cstdio>
+#include <limits>
 #include <vector>
 
+#include "cpp/quantize/pixel_view.h"
+#include "cpp/quantize/wu_cut.h"
+#include "cpp/utils/parallel.h"
+#include "cpp/utils/simd.h"
 #include "cpp/utils/utils.h"
 
 namespace material_color_utilities {
@@ -43,216 +50,226 @@ enum class Direction {
   kBlue,
 };
 
-constexpr int kIndexBits = 5;
-constexpr int kIndexCount = ((1 << kIndexBits) + 1);
-constexpr int kTotalSize = (kIndexCount * kIndexCount * kIndexCount);
 constexpr int kMaxColors = 256;
 
-using IntArray = std::vector<int64_t>;
-using DoubleArray = std::vector<double>;
+// Channel sums over this many pixels fit in 32 bits.
+constexpr size_t kMaxPixelsFor32BitMoments =
+    std::numeric_limits<int32_t>::max() / 255;
 
-int GetIndex(int r, int g, int b) {
-  return (r << (kIndexBits * 2)) + (r << (kIndexBits + 1)) + (g << kIndexBits) +
-         r + g + b;
-}
+// Each thread building part of a histogram reads at least this many pixels,
+// so that reading them outweighs clearing and summing a private histogram.
+constexpr size_t kMinPixelsPerThread = size_t{1} << 20;
+
+/**
+ * The dimensions of a histogram whose bins are selected by the top
+ * `kIndexBits` bits of each channel. Index 0 of each axis is left empty so
+ * that cumulative moments need no special case at the edges.
+ */
+template <int kBits>
+struct Grid {
+  static constexpr int kIndexBits = kBits;
+  static constexpr int kIndexCount = ((1 << kIndexBits) + 1);
+  static constexpr int kTotalSize = (kIndexCount * kIndexCount * kIndexCount);
+
+  static int GetIndex(int r, int g, int b) {
+    return (r << (kIndexBits * 2)) + (r << (kIndexBits + 1)) +
+           (g << kIndexBits) + r + g + b;
+  }
+};
+
+using DefaultGrid = Grid<5>;
 
-void ConstructHistogram(const std::vector<Argb>& pixels, IntArray& weights,
-                        IntArray& m_r, IntArray& m_g, IntArray& m_b,
-                        DoubleArray& moments) {
-  for (size_t i = 0; i < pixels.size(); i++) {
-    Argb pixel = pixels[i];
+/**
+ * Adds pixels to the histogram.
+ *
+ * @return the number of pixels added.
+ */
+template <typename G, typename Int>
+int64_t ConstructHistogram(const PixelView& pixels,
+                           std::vector<WuBin<Int>>& bins,
+                           std::vector<double>& moments) {
+  int64_t count = 0;
+  ForEachPixel(pixels, [&](Argb pixel) {
+    count++;
     int red = RedFromInt(pixel);
     int green = GreenFromInt(pixel);
     int blue = BlueFromInt(pixel);
 
-    int bits_to_remove = 8 - kIndexBits;
+    int bits_to_remove = 8 - G::kIndexBits;
     int index_r = (red >> bits_to_remove) + 1;
     int index_g = (green >> bits_to_remove) + 1;
     int index_b = (blue >> bits_to_remove) + 1;
-    int index = GetIndex(index_r, index_g, index_b);
+    int index = G::GetIndex(index_r, index_g, index_b);
 
-    weights[index]++;
-    m_r[index] += red;
-    m_g[index] += green;
-    m_b[index] += blue;
+    WuBin<Int>& bin = bins[index];
+    bin.weight++;
+    bin.red += red;
+    bin.green += green;
+    bin.blue += blue;
     moments[index] += (red * red) + (green * green) + (blue * blue);
-  }
+  });
+  return count;
+}
+
+template <typename To, typename From>
+void AddBin(const WuBin<From>& from, WuBin<To>* to) {
+  to->weight += from.weight;
+  to->red += from.red;
+  to->green += from.green;
+  to->blue += from.blue;
 }
 
-void ComputeMoments(IntArray& weights, IntArray& m_r, IntArray& m_g,
-                    IntArray& m_b, DoubleArray& moments) {
-  for (int r = 1; r < kIndexCount; r++) {
-    int64_t area[kIndexCount] = {};
-    int64_t area_r[kIndexCount] = {};
-    int64_t area_g[kIndexCount] = {};
-    int64_t area_b[kIndexCount] = {};
-    double area_2[kIndexCount] = {};
-    for (int g = 1; g < kIndexCount; g++) {
-      int64_t line = 0;
-      int64_t line_r = 0;
-      int64_t line_g = 0;
-      int64_t line_b = 0;
+template <typename G, typename Int>
+void ComputeMoments(std::vector<WuBin<Int>>& bins,
+                    std::vector<double>& moments) {
+  for (int r = 1; r < G::kIndexCount; r++) {
+    WuBin<int64_t> area[G::kIndexCount] = {};
+    double area_2[G::kIndexCount] = {};
+    for (int g = 1; g < G::kIndexCount; g++) {
+      WuBin<int64_t> line;
       double line_2 = 0.0;
-      for (int b = 1; b < kIndexCount; b++) {
-        int index = GetIndex(r, g, b);
-        line += weights[index];
-        line_r += m_r[index];
-        line_g += m_g[index];
-        line_b += m_b[index];
+      for (int b = 1; b < G::kIndexCount; b++) {
+        int index = G::GetIndex(r, g, b);
+        WuBin<Int>& bin = bins[index];
+        AddBin(bin, &line);
         line_2 += moments[index];
 
-        area[b] += line;
-        area_r[b] += line_r;
-        area_g[b] += line_g;
-        area_b[b] += line_b;
+        AddBin(line, &area[b]);
         area_2[b] += line_2;
 
-        int previous_index = GetIndex(r - 1, g, b);
-        weights[index] = weights[previous_index] + area[b];
-        m_r[index] = m_r[previous_index] + area_r[b];
-        m_g[index] = m_g[previous_index] + area_g[b];
-        m_b[index] = m_b[previous_index] + area_b[b];
+        int previous_index = G::GetIndex(r - 1, g, b);
+        const WuBin<Int>& previous = bins[previous_index];
+        bin.weight = previous.weight + area[b].weight;
+        bin.red = previous.red + area[b].red;
+        bin.green = previous.green + area[b].green;
+        bin.blue = previous.blue + area[b].blue;
         moments[index] = moments[previous_index] + area_2[b];
       }
     }
   }
 }
 
-int64_t Top(const Box& cube, const Direction direction, const int position,
-            const IntArray& moment) {
-  if (direction == Direction::kRed) {
-    return (moment[GetIndex(position, cube.g1, cube.b1)] -
-            moment[GetIndex(position, cube.g1, cube.b0)] -
-            moment[GetIndex(position, cube.g0, cube.b1)] +
-            moment[GetIndex(position, cube.g0, cube.b0)]);
-  } else if (direction == Direction::kGreen) {
-    return (moment[GetIndex(cube.r1, position, cube.b1)] -
-            moment[GetIndex(cube.r1, position, cube.b0)] -
-            moment[GetIndex(cube.r0, position, cube.b1)] +
-            moment[GetIndex(cube.r0, position, cube.b0)]);
-  } else {
-    return (moment[GetIndex(cube.r1, cube.g1, position)] -
-            moment[GetIndex(cube.r1, cube.g0, position)] -
-            moment[GetIndex(cube.r0, cube.g1, position)] +
-            moment[GetIndex(cube.r0, cube.g0, position)]);
-  }
+// Moments may be stored in 32 bits, but sums of them are formed in 64 bits:
+// the partial sums of an inclusion-exclusion can exceed the final result.
+
+/**
+ * Returns the moments of every pixel in `cube`.
+ */
+template <typename G, typename Int>
+WuBin<int64_t> Volume(const Box& cube, const std::vector<WuBin<Int>>& bins) {
+  const WuBin<Int>& c111 = bins[G::GetIndex(cube.r1, cube.g1, cube.b1)];
+  const WuBin<Int>& c110 = bins[G::GetIndex(cube.r1, cube.g1, cube.b0)];
+  const WuBin<Int>& c101 = bins[G::GetIndex(cube.r1, cube.g0, cube.b1)];
+  const WuBin<Int>& c100 = bins[G::GetIndex(cube.r1, cube.g0, cube.b0)];
+  const WuBin<Int>& c011 = bins[G::GetIndex(cube.r0, cube.g1, cube.b1)];
+  const WuBin<Int>& c010 = bins[G::GetIndex(cube.r0, cube.g1, cube.b0)];
+  const WuBin<Int>& c001 = bins[G::GetIndex(cube.r0, cube.g0, cube.b1)];
+  const WuBin<Int>& c000 = bins[G::GetIndex(cube.r0, cube.g0, cube.b0)];
+  auto sum = [&](Int WuBin<Int>::*moment) {
+    return int64_t{c111.*moment} - c110.*moment - c101.*moment +
+           c100.*moment - c011.*moment + c010.*moment + c001.*moment -
+           c000.*moment;
+  };
+  return {sum(&WuBin<Int>::weight), sum(&WuBin<Int>::red),
+          sum(&WuBin<Int>::green), sum(&WuBin<Int>::blue)};
 }
 
-int64_t Bottom(const Box& cube, const Direction direction,
-               const IntArray& moment) {
+template <typename G, typename Int>
+double Variance(const Box& cube, const std::vector<WuBin<Int>>& bins,
+                const std::vector<double>& moments) {
+  WuBin<int64_t> volume = Volume<G>(cube, bins);
+  double dr = volume.red;
+  double dg = volume.green;
+  double db = volume.blue;
+  double xx = moments[G::GetIndex(cube.r1, cube.g1, cube.b1)] -
+              moments[G::GetIndex(cube.r1, cube.g1, cube.b0)] -
+              moments[G::GetIndex(cube.r1, cube.g0, cube.b1)] +
+              moments[G::GetIndex(cube.r1, cube.g0, cube.b0)] -
+              moments[G::GetIndex(cube.r0, cube.g1, cube.b1)] +
+              moments[G::GetIndex(cube.r0, cube.g1, cube.b0)] +
+              moments[G::GetIndex(cube.r0, cube.g0, cube.b1)] -
+              moments[G::GetIndex(cube.r0, cube.g0, cube.b0)];
+  double hypotenuse = dr * dr + dg * dg + db * db;
+  double volume_weight = volume.weight;
+  return xx - hypotenuse / volume_weight;
+}
+
+/**
+ * Finds the cut of `cube` along `direction`, at a position from `first` to
+ * `last - 1`, that best separates its colors.
+ *
+ * Cutting at any position reads the same four columns of the histogram, so
+ * the corners of the box are located once and the columns are walked with a
+ * fixed stride.
+ *
+ * @return the score of the best cut, stored in `cut`; 0 if no cut leaves
+ *         pixels on both sides, in which case `cut` is -1.
+ */
+template <typename G, typename Int>
+double Maximize(SimdLevel simd_level, const Box& cube,
+                const Direction direction, const int first, const int last,
+                int* cut, const WuBin<int64_t>& whole,
+                const std::vector<WuBin<Int>>& bins) {
+  WuCutAxis<Int> axis;
+  axis.bins = bins.data();
+  axis.whole = whole;
   if (direction == Direction::kRed) {
-    return (-moment[GetIndex(cube.r0, cube.g1, cube.b1)] +
-            moment[GetIndex(cube.r0, cube.g1, cube.b0)] +
-            moment[GetIndex(cube.r0, cube.g0, cube.b1)] -
-            moment[GetIndex(cube.r0, cube.g0, cube.b0)]);
+    axis.stride = G::GetIndex(1, 0, 0);
+    axis.corners[0] = G::GetIndex(0, cube.g1, cube.b1);
+    axis.corners[1] = G::GetIndex(0, cube.g1, cube.b0);
+    axis.corners[2] = G::GetIndex(0, cube.g0, cube.b1);
+    axis.corners[3] = G::GetIndex(0, cube.g0, cube.b0);
   } else if (direction == Direction::kGreen) {
-    return (-moment[GetIndex(cube.r1, cube.g0, cube.b1)] +
-            moment[GetIndex(cube.r1, cube.g0, cube.b0)] +
-            moment[GetIndex(cube.r0, cube.g0, cube.b1)] -
-            moment[GetIndex(cube.r0, cube.g0, cube.b0)]);
+    axis.stride = G::GetIndex(0, 1, 0);
+    axis.corners[0] = G::GetIndex(cube.r1, 0, cube.b1);
+    axis.corners[1] = G::GetIndex(cube.r1, 0, cube.b0);
+    axis.corners[2] = G::GetIndex(cube.r0, 0, cube.b1);
+    axis.corners[3] = G::GetIndex(cube.r0, 0, cube.b0);
   } else {
-    return (-moment[GetIndex(cube.r1, cube.g1, cube.b0)] +
-            moment[GetIndex(cube.r1, cube.g0, cube.b0)] +
-            moment[GetIndex(cube.r0, cube.g1, cube.b0)] -
-            moment[GetIndex(cube.r0, cube.g0, cube.b0)]);
+    axis.stride = G::GetIndex(0, 0, 1);
+    axis.corners[0] = G::GetIndex(cube.r1, cube.g1, 0);
+    axis.corners[1] = G::GetIndex(cube.r1, cube.g0, 0);
+    axis.corners[2] = G::GetIndex(cube.r0, cube.g1, 0);
+    axis.corners[3] = G::GetIndex(cube.r0, cube.g0, 0);
   }
-}
-
-int64_t Vol(const Box& cube, const IntArray& moment) {
-  return (moment[GetIndex(cube.r1, cube.g1, cube.b1)] -
-          moment[GetIndex(cube.r1, cube.g1, cube.b0)] -
-          moment[GetIndex(cube.r1, cube.g0, cube.b1)] +
-          moment[GetIndex(cube.r1, cube.g0, cube.b0)] -
-          moment[GetIndex(cube.r0, cube.g1, cube.b1)] +
-          moment[GetIndex(cube.r0, cube.g1, cube.b0)] +
-          moment[GetIndex(cube.r0, cube.g0, cube.b1)] -
-          moment[GetIndex(cube.r0, cube.g0, cube.b0)]);
-}
 
-double Variance(const Box& cube, const IntArray& weights, const IntArray& m_r,
-                const IntArray& m_g, const IntArray& m_b,
-                const DoubleArray& moments) {
-  double dr = Vol(cube, m_r);
-  double dg = Vol(cube, m_g);
-  double db = Vol(cube, m_b);
-  double xx = moments[GetIndex(cube.r1, cube.g1, cube.b1)] -
-              moments[GetIndex(cube.r1, cube.g1, cube.b0)] -
-              moments[GetIndex(cube.r1, cube.g0, cube.b1)] +
-              moments[GetIndex(cube.r1, cube.g0, cube.b0)] -
-              moments[GetIndex(cube.r0, cube.g1, cube.b1)] +
-              moments[GetIndex(cube.r0, cube.g1, cube.b0)] +
-              moments[GetIndex(cube.r0, cube.g0, cube.b1)] -
-              moments[GetIndex(cube.r0, cube.g0, cube.b0)];
-  double hypotenuse = dr * dr + dg * dg + db * db;
-  double volume = Vol(cube, weights);
-  return xx - hypotenuse / volume;
-}
+  // The box starts just above position first - 1, so subtracting that
+  // position's columns leaves only the part of each column inside the box.
+  const WuBin<Int>* base = axis.bins + (first - 1) * axis.stride;
+  auto bottom = [&](Int WuBin<Int>::*moment) {
+    return -int64_t{base[axis.corners[0]].*moment} +
+           base[axis.corners[1]].*moment + base[axis.corners[2]].*moment -
+           base[axis.corners[3]].*moment;
+  };
+  axis.bottom = {bottom(&WuBin<Int>::weight), bottom(&WuBin<Int>::red),
+                 bottom(&WuBin<Int>::green), bottom(&WuBin<Int>::blue)};
 
-double Maximize(const Box& cube, const Direction direction, const int first,
-                const int last, int* cut, const int64_t whole_w,
-                const int64_t whole_r, const int64_t whole_g,
-                const int64_t whole_b, const IntArray& weights,
-                const IntArray& m_r, const IntArray& m_g, const IntArray& m_b) {
-  int64_t bottom_r = Bottom(cube, direction, m_r);
-  int64_t bottom_g = Bottom(cube, direction, m_g);
-  int64_t bottom_b = Bottom(cube, direction, m_b);
-  int64_t bottom_w = Bottom(cube, direction, weights);
+  double scores[G::kIndexCount];
+  ScoreWuCuts(simd_level, axis, first, last, scores);
 
   double max = 0.0;
   *cut = -1;
-
-  int64_t half_r, half_g, half_b, half_w;
   for (int i = first; i < last; i++) {
-    half_r = bottom_r + Top(cube, direction, i, m_r);
-    half_g = bottom_g + Top(cube, direction, i, m_g);
-    half_b = bottom_b + Top(cube, direction, i, m_b);
-    half_w = bottom_w + Top(cube, direction, i, weights);
-    if (half_w == 0) {
-      continue;
-    }
-
-    double temp = (static_cast<double>(half_r) * half_r +
-                   static_cast<double>(half_g) * half_g +
-                   static_cast<double>(half_b) * half_b) /
-                  static_cast<double>(half_w);
-
-    half_r = whole_r - half_r;
-    half_g = whole_g - half_g;
-    half_b = whole_b - half_b;
-    half_w = whole_w - half_w;
-    if (half_w == 0) {
-      continue;
-    }
-    temp += (static_cast<double>(half_r) * half_r +
-             static_cast<double>(half_g) * half_g +
-             static_cast<double>(half_b) * half_b) /
-            static_cast<double>(half_w);
-
-    if (temp > max) {
-      max = temp;
+    if (scores[i - first] > max) {
+      max = scores[i - first];
       *cut = i;
     }
   }
   return max;
 }
 
-bool Cut(Box& box1, Box& box2, const IntArray& weights, const IntArray& m_r,
-         const IntArray& m_g, const IntArray& m_b) {
-  int64_t whole_r = Vol(box1, m_r);
-  int64_t whole_g = Vol(box1, m_g);
-  int64_t whole_b = Vol(box1, m_b);
-  int64_t whole_w = Vol(box1, weights);
+template <typename G, typename Int>
+bool Cut(SimdLevel simd_level, Box& box1, Box& box2,
+         const std::vector<WuBin<Int>>& bins) {
+  WuBin<int64_t> whole = Volume<G>(box1, bins);
 
   int cut_r, cut_g, cut_b;
-  double max_r =
-      Maximize(box1, Direction::kRed, box1.r0 + 1, box1.r1, &cut_r, whole_w,
-               whole_r, whole_g, whole_b, weights, m_r, m_g, m_b);
-  double max_g =
-      Maximize(box1, Direction::kGreen, box1.g0 + 1, box1.g1, &cut_g, whole_w,
-               whole_r, whole_g, whole_b, weights, m_r, m_g, m_b);
-  double max_b =
-      Maximize(box1, Direction::kBlue, box1.b0 + 1, box1.b1, &cut_b, whole_w,
-               whole_r, whole_g, whole_b, weights, m_r, m_g, m_b);
+  double max_r = Maximize<G>(simd_level, box1, Direction::kRed, box1.r0 + 1,
+                             box1.r1, &cut_r, whole, bins);
+  double max_g = Maximize<G>(simd_level, box1, Direction::kGreen, box1.g0 + 1,
+                             box1.g1, &cut_g, whole, bins);
+  double max_b = Maximize<G>(simd_level, box1, Direction::kBlue, box1.b0 + 1,
+                             box1.b1, &cut_b, whole, bins);
 
   Direction direction;
   if (max_r >= max_g && max_r >= max_b) {
@@ -289,38 +306,31 @@ bool Cut(Box& box1, Box& box2, const IntArray& weights, const IntArray& m_r,
   return true;
 }
 
-std::vector<Argb> QuantizeWu(const std::vector<Argb>& pixels,
-                             uint16_t max_colors) {
-  if (max_colors <= 0 || max_colors > 256 || pixels.empty()) {
-    return std::vector<Argb>();
-  }
-
-  IntArray weights(kTotalSize, 0);
-  IntArray moments_red(kTotalSize, 0);
-  IntArray moments_green(kTotalSize, 0);
-  IntArray moments_blue(kTotalSize, 0);
-  DoubleArray moments(kTotalSize, 0.0);
-  ConstructHistogram(pixels, weights, moments_red, moments_green, moments_blue,
-                     moments);
-  ComputeMoments(weights, moments_red, moments_green, moments_blue, moments);
-
-  std::vector<Box> cubes(kMaxColors);
+/**
+ * Cuts the color space into at most max_colors boxes using a histogram built
+ * by ConstructHistogram. The histogram is overwritten with its cumulative
+ * moments.
+ */
+template <typename G, typename Int>
+std::vector<Argb> QuantizeHistogram(std::vector<WuBin<Int>>& bins,
+                                    std::vector<double>& moments,
+                                    uint16_t max_colors) {
+  ComputeMoments<G>(bins, moments);
+  SimdLevel simd_level = BestSimdLevel();
+
+  std::array<Box, kMaxColors> cubes;
   cubes[0].r0 = cubes[0].g0 = cubes[0].b0 = 0;
-  cubes[0].r1 = cubes[0].g1 = cubes[0].b1 = kIndexCount - 1;
+  cubes[0].r1 = cubes[0].g1 = cubes[0].b1 = G::kIndexCount - 1;
 
-  std::vector<double> volume_variance(kMaxColors);
+  std::array<double, kMaxColors> volume_variance = {};
   int next = 0;
   for (int i = 1; i < max_colors; ++i) {
-    if (Cut(cubes[next], cubes[i], weights, moments_red, moments_green,
-            moments_blue)) {
-      volume_variance[next] =
-          cubes[next].vol > 1 ? Variance(cubes[next], weights, moments_red,
-                                         moments_green, moments_blue, moments)
-                              : 0.0;
-      volume_variance[i] = cubes[i].vol > 1
-                               ? Variance(cubes[i], weights, moments_red,
-                                          moments_green, moments_blue, moments)
-                               : 0.0;
+    if (Cut<G>(simd_level, cubes[next], cubes[i], bins)) {
+      volume_variance[next] = cubes[next].vol > 1
+                                  ? Variance<G>(cubes[next], bins, moments)
+                                  : 0.0;
+      volume_variance[i] =
+          cubes[i].vol > 1 ? Variance<G>(cubes[i], bins, moments) : 0.0;
     } else {
       volume_variance[next] = 0.0;
       i--;
@@ -341,12 +351,13 @@ std::vector<Argb> QuantizeWu(const std::vector<Argb>& pixels,
   }
 
   std::vector<Argb> out_colors;
+  out_colors.reserve(max_colors);
   for (int i = 0; i < max_colors; ++i) {
-    int64_t weight = Vol(cubes[i], weights);
-    if (weight > 0) {
-      int32_t red = Vol(cubes[i], moments_red) / weight;
-      int32_t green = Vol(cubes[i], moments_green) / weight;
-      int32_t blue = Vol(cubes[i], moments_blue) / weight;
+    WuBin<int64_t> volume = Volume<G>(cubes[i], bins);
+    if (volume.weight > 0) {
+      int32_t red = volume.red / volume.weight;
+      int32_t green = volume.green / volume.weight;
+      int32_t blue = volume.blue / volume.weight;
       uint32_t argb = ArgbFromRgb(red, green, blue);
       out_colors.push_back(argb);
     }
@@ -354,4 +365,154 @@ std::vector<Argb> QuantizeWu(const std::vector<Argb>& pixels,
 
   return out_colors;
 }
+
+/**
+ * Returns part `part` of `count` nearly equal parts of `pixels`: a band of
+ * rows, or of columns if the image has fewer rows than parts.
+ */
+PixelView PartOfImage(const PixelView& pixels, int part, int count) {
+  if (pixels.height >= count) {
+    int begin = static_cast<int64_t>(pixels.height) * part / count;
+    int end = static_cast<int64_t>(pixels.height) * (part + 1) / count;
+    return pixels.Crop(0, begin, pixels.width, end - begin);
+  }
+  int begin = static_cast<int64_t>(pixels.width) * part / count;
+  int end = static_cast<int64_t>(pixels.width) * (part + 1) / count;
+  return pixels.Crop(begin, 0, end - begin, pixels.height);
+}
+
+/**
+ * Builds the histogram of `pixels` in `histogram`, whose arrays are cleared
+ * but keep their capacity.
+ *
+ * A large image is split into parts read on separate threads, each into a
+ * private histogram, and the histograms are then summed. Every bin holds a
+ * sum of integers, so the result is exactly that of reading the image on one
+ * thread.
+ */
+template <typename G, typename Moments>
+void BuildHistogram(const PixelView& pixels, int num_threads,
+                    Moments& histogram) {
+  size_t max_threads =
+      std::max<size_t>(1, pixels.pixel_count() / kMinPixelsPerThread);
+  int thread_count = static_cast<int>(
+      std::min<size_t>(std::max(1, num_threads), max_threads));
+  histogram.bins.assign(G::kTotalSize, {});
+  histogram.moments.assign(G::kTotalSize, 0.0);
+  if (thread_count == 1) {
+    ConstructHistogram<G>(pixels, histogram.bins, histogram.moments);
+    return;
+  }
+
+  histogram.thread_bins.resize(thread_count - 1);
+  histogram.thread_moments.resize(thread_count - 1);
+  ParallelFor(thread_count, thread_count, [&](int part) {
+    auto& bins = part == 0 ? histogram.bins : histogram.thread_bins[part - 1];
+    std::vector<double>& moments =
+        part == 0 ? histogram.moments : histogram.thread_moments[part - 1];
+    if (part > 0) {
+      bins.assign(G::kTotalSize, {});
+      moments.assign(G::kTotalSize, 0.0);
+    }
+    ConstructHistogram<G>(PartOfImage(pixels, part, thread_count), bins,
+                          moments);
+  });
+
+  // Each thread sums one range of bins across every private histogram.
+  ParallelFor(thread_count, thread_count, [&](int part) {
+    int begin = G::kTotalSize * part / thread_count;
+    int end = G::kTotalSize * (part + 1) / thread_count;
+    for (int thread = 0; thread < thread_count - 1; thread++) {
+      const auto& bins = histogram.thread_bins[thread];
+      const std::vector<double>& moments = histogram.thread_moments[thread];
+      for (int i = begin; i < end; i++) {
+        AddBin(bins[i], &histogram.bins[i]);
+        histogram.moments[i] += moments[i];
+      }
+    }
+  });
+}
+
+/**
+ * Builds the histogram of `pixels` in `histogram` and quantizes it.
+ */
+template <typename G, typename Moments>
+std::vector<Argb> QuantizeWithGrid(const PixelView& pixels,
+                                   uint16_t max_colors, int num_threads,
+                                   Moments& histogram) {
+  BuildHistogram<G>(pixels, num_threads, histogram);
+  return QuantizeHistogram<G>(histogram.bins, histogram.moments, max_colors);
+}
+
+template <typename Moments>
+std::vector<Argb> QuantizeWithMoments(const PixelView& pixels,
+                                      uint16_t max_colors,
+                                      const WuOptions& options,
+                                      Moments& histogram) {
+  switch (options.index_bits) {
+    case 4:
+      return QuantizeWithGrid<Grid<4>>(pixels, max_colors, options.num_threads,
+                                       histogram);
+    case 6:
+      return QuantizeWithGrid<Grid<6>>(pixels, max_colors, options.num_threads,
+                                       histogram);
+    default:
+      return QuantizeWithGrid<Grid<5>>(pixels, max_colors, options.num_threads,
+                                       histogram);
+  }
+}
+
+std::vector<Argb> QuantizeWu(const std::vector<Argb>& pixels,
+                             uint16_t max_colors, const WuOptions& options,
+                             WuWorkspace* workspace) {
+  return QuantizeWu(PixelView(pixels), max_colors, options, workspace);
+}
+
+std::vector<Argb> QuantizeWu(const PixelView& pixels, uint16_t max_colors,
+                             const WuOptions& options, WuWorkspace* workspace) {
+  if (max_colors <= 0 || max_colors > 256 || pixels.pixel_count() == 0) {
+    return std::vector<Argb>();
+  }
+
+  WuWorkspace local_workspace;
+  if (workspace == nullptr) {
+    workspace = &local_workspace;
+  }
+  if (pixels.pixel_count() <= kMaxPixelsFor32BitMoments) {
+    return QuantizeWithMoments(pixels, max_colors, options, workspace->narrow_);
+  }
+  return QuantizeWithMoments(pixels, max_colors, options, workspace->wide_);
+}
+
+WuHistogram::WuHistogram()
+    : bins_(DefaultGrid::kTotalSize), moments_(DefaultGrid::kTotalSize, 0.0) {}
+
+void WuHistogram::Add(absl::Span<const Argb> pixels) {
+  Add(PixelView(pixels));
+}
+
+void WuHistogram::Add(const PixelView& pixels) {
+  pixel_count_ += ConstructHistogram<DefaultGrid>(pixels, bins_, moments_);
+}
+
+void WuHistogram::Merge(const WuHistogram& other) {
+  // Every bin holds a sum of integers, so merging is exact even for the
+  // floating-point moments.
+  for (int i = 0; i < DefaultGrid::kTotalSize; i++) {
+    AddBin(other.bins_[i], &bins_[i]);
+    moments_[i] += other.moments_[i];
+  }
+  pixel_count_ += other.pixel_count_;
+}
+
+std::vector<Argb> WuHistogram::Quantize(uint16_t max_colors) const {
+  if (max_colors <= 0 || max_colors > 256 || pixel_count_ == 0) {
+    return std::vector<Argb>();
+  }
+
+  std::vector<WuBin<int64_t>> bins = bins_;
+  std::vector<double> moments = moments_;
+  return QuantizeHistogram<DefaultGrid>(bins, moments, max_colors);
+}
+
 }  // namespace material_color_utilities
@@ -21,11 +21,121 @@
 
 #include <vector>
 
+#include "absl/types/span.h"
+#include "cpp/quantize/pixel_view.h"
+#include "cpp/quantize/wu_cut.h"
 #include "cpp/utils/utils.h"
 
 namespace material_color_utilities {
 
+/**
+ * Options for QuantizeWu.
+ * `index_bits`: bits of each color channel that select a histogram bin; 4, 5
+ *               or 6. Fewer bits make a smaller, faster histogram suited to
+ *               thumbnails; more bits separate similar colors in large images.
+ * `num_threads`: maximum number of threads used to build the histogram. Each
+ *                thread reads at least a megapixel, so smaller images are
+ *                read on the calling thread alone. The result is identical
+ *                for any thread count.
+ */
+struct WuOptions {
+  int index_bits = 5;
+  int num_threads = 1;
+};
+
+class WuWorkspace;
+
+/**
+ * Quantizes pixels with Wu's algorithm.
+ *
+ * @param max_colors 1 <= max_colors <= 256.
+ * @param workspace If given, holds the histogram between calls, so that
+ *                  repeated calls do not allocate. May be null.
+ * @return at most max_colors colors.
+ */
 std::vector<Argb> QuantizeWu(const std::vector<Argb>& pixels,
-                             uint16_t max_colors);
-}
+                             uint16_t max_colors, const WuOptions& options = {},
+                             WuWorkspace* workspace = nullptr);
+
+/**
+ * Variant of QuantizeWu that reads pixels in place from a caller-owned image.
+ */
+std::vector<Argb> QuantizeWu(const PixelView& pixels, uint16_t max_colors,
+                             const WuOptions& options = {},
+                             WuWorkspace* workspace = nullptr);
+
+/**
+ * Storage for the histograms built by QuantizeWu, owned by the caller and
+ * reused across calls with any options. Moments are stored in 32 bits when
+ * the pixel count guarantees they cannot overflow, halving the histogram's
+ * cache footprint, and in 64 bits otherwise.
+ *
+ * A workspace must not be used by two calls at once.
+ */
+class WuWorkspace {
+ private:
+  template <typename Int>
+  struct Moments {
+    std::vector<WuBin<Int>> bins;
+    std::vector<double> moments;
+    // Private histograms of all threads but the first, which are summed into
+    // `bins` and `moments`.
+    std::vector<std::vector<WuBin<Int>>> thread_bins;
+    std::vector<std::vector<double>> thread_moments;
+  };
+
+  Moments<int32_t> narrow_;
+  Moments<int64_t> wide_;
+
+  friend std::vector<Argb> QuantizeWu(const PixelView& pixels,
+                                      uint16_t max_colors,
+                                      const WuOptions& options,
+                                      WuWorkspace* workspace);
+};
+
+/**
+ * Accumulates the color histogram used by the Wu quantizer incrementally, so
+ * that an image can be quantized without holding all of its pixels at once.
+ *
+ * Pixels can be added in any number of batches, e.g. scanline tiles as they
+ * are decoded, and histograms built separately, e.g. on several threads, can
+ * be merged. Quantizing the accumulated histogram gives exactly the same
+ * result as QuantizeWu on all of the pixels.
+ */
+class WuHistogram {
+ public:
+  WuHistogram();
+
+  /**
+   * Adds pixels to the histogram.
+   */
+  void Add(absl::Span<const Argb> pixels);
+  void Add(const PixelView& pixels);
+
+  /**
+   * Adds every pixel accumulated by another histogram to this one.
+   */
+  void Merge(const WuHistogram& other);
+
+  /**
+   * Returns the number of pixels added so far.
+   */
+  int64_t pixel_count() const { return pixel_count_; }
+
+  /**
+   * Runs the Wu quantizer on the pixels added so far. The histogram is left
+   * unchanged, so more pixels may be added afterwards.
+   *
+   * @param max_colors 1 <= max_colors <= 256.
+   * @return at most max_colors colors; empty if no pixels were added.
+   */
+  std::vector<Argb> Quantize(uint16_t max_colors) const;
+
+ private:
+  int64_t pixel_count_ = 0;
+  std::vector<WuBin<int64_t>> bins_;
+  std::vector<double> moments_;
+};
+
+}  // namespace material_color_utilities
 #endif  // CPP_QUANTIZE_WU_H_
@@ -0,0 +1,115 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include "testing/base/public/benchmark.h"
+#include "cpp/quantize/synthetic_images.h"
+#include "cpp/quantize/wu.h"
+#include "cpp/quantize/wu_cut.h"
+#include "cpp/utils/simd.h"
+#include "cpp/utils/utils.h"
+
+namespace material_color_utilities {
+
+namespace {
+
+void BM_QuantizeWu(benchmark::State& state) {
+  WuOptions options;
+  options.index_bits = state.range(0);
+  int size = state.range(1);
+  bool reuse_workspace = state.range(2);
+  std::vector<Argb> pixels = SyntheticImageCorpus(size, size)[0].pixels;
+  WuWorkspace workspace;
+  for (auto s : state) {
+    benchmark::DoNotOptimize(QuantizeWu(
+        pixels, 128, options, reuse_workspace ? &workspace : nullptr));
+  }
+  state.SetLabel(reuse_workspace ? "workspace" : "no_workspace");
+  state.SetItemsProcessed(state.iterations() * pixels.size());
+}
+BENCHMARK(BM_QuantizeWu)
+    ->ArgsProduct({{4, 5, 6}, {112, 512}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+
+// Only images of at least two megapixels are split across threads.
+void BM_QuantizeWuThreads(benchmark::State& state) {
+  WuOptions options;
+  options.num_threads = state.range(0);
+  int size = state.range(1);
+  std::vector<Argb> pixels(static_cast<size_t>(size) * size);
+  for (size_t i = 0; i < pixels.size(); i++) {
+    pixels[i] = 0xff000000 | ((i * 2654435761u) & 0xffffff);
+  }
+  WuWorkspace workspace;
+  for (auto s : state) {
+    benchmark::DoNotOptimize(QuantizeWu(pixels, 128, options, &workspace));
+  }
+  state.SetItemsProcessed(state.iterations() * pixels.size());
+}
+BENCHMARK(BM_QuantizeWuThreads)
+    ->ArgsProduct({{1, 2, 4, 8}, {512, 2048, 4896}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// Box cutting dominates on thumbnails, where the histogram is quick to build.
+void BM_QuantizeWuColors(benchmark::State& state) {
+  int max_colors = state.range(0);
+  std::vector<Argb> pixels = SyntheticImageCorpus(112, 112)[0].pixels;
+  WuWorkspace workspace;
+  for (auto s : state) {
+    benchmark::DoNotOptimize(QuantizeWu(pixels, max_colors, {}, &workspace));
+  }
+  state.SetItemsProcessed(state.iterations() * max_colors);
+}
+BENCHMARK(BM_QuantizeWuColors)
+    ->Arg(128)
+    ->Arg(256)
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_ScoreWuCuts(benchmark::State& state) {
+  SimdLevel level = static_cast<SimdLevel>(state.range(0));
+  srand(42688);
+  std::vector<WuBin<int32_t>> bins(33 * 33 * 33);
+  for (WuBin<int32_t>& bin : bins) {
+    bin = {rand() % 1000, rand() % 255000, rand() % 255000, rand() % 255000};
+  }
+  WuCutAxis<int32_t> axis;
+  axis.bins = bins.data();
+  axis.stride = 33;
+  axis.corners[0] = 33 * 33 * 31 + 31;
+  axis.corners[1] = 33 * 33 * 31 + 1;
+  axis.corners[2] = 33 * 33 * 1 + 31;
+  axis.corners[3] = 33 * 33 * 1 + 1;
+  axis.bottom = {0, 0, 0, 0};
+  axis.whole = {1000000, 255000000, 255000000, 255000000};
+  double scores[32];
+  for (auto s : state) {
+    ScoreWuCuts(level, axis, 1, 32, scores);
+    benchmark::DoNotOptimize(scores);
+  }
+  state.SetLabel(SimdLevelName(level));
+  state.SetItemsProcessed(state.iterations() * 31);
+}
+BENCHMARK(BM_ScoreWuCuts)
+    ->Arg(static_cast<int>(SimdLevel::kScalar))
+    ->Arg(static_cast<int>(SimdLevel::kSse42))
+    ->Arg(static_cast<int>(SimdLevel::kAvx2));
+
+}  // namespace
+}  // namespace material_color_utilities
@@ -0,0 +1,267 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpp/quantize/wu_cut.h"
+
+#include <cstdint>
+
+#include "cpp/utils/simd.h"
+
+#ifdef MCU_HAS_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace material_color_utilities {
+
+namespace {
+
+template <typename Int>
+inline void ScalarScores(const WuCutAxis<Int>& axis, int begin, int first,
+                         int last, double* scores) {
+  const int* corners = axis.corners;
+  for (int i = begin; i < last; i++) {
+    const WuBin<Int>* bins = axis.bins + i * axis.stride;
+    const WuBin<Int>& c0 = bins[corners[0]];
+    const WuBin<Int>& c1 = bins[corners[1]];
+    const WuBin<Int>& c2 = bins[corners[2]];
+    const WuBin<Int>& c3 = bins[corners[3]];
+    // Sums are formed in 64 bits: the partial sums of an
+    // inclusion-exclusion can exceed the final result.
+    int64_t half_w = axis.bottom.weight +
+                     (int64_t{c0.weight} - c1.weight - c2.weight + c3.weight);
+    int64_t half_r =
+        axis.bottom.red + (int64_t{c0.red} - c1.red - c2.red + c3.red);
+    int64_t half_g = axis.bottom.green +
+                     (int64_t{c0.green} - c1.green - c2.green + c3.green);
+    int64_t half_b =
+        axis.bottom.blue + (int64_t{c0.blue} - c1.blue - c2.blue + c3.blue);
+    int64_t other_w = axis.whole.weight - half_w;
+    int64_t other_r = axis.whole.red - half_r;
+    int64_t other_g = axis.whole.green - half_g;
+    int64_t other_b = axis.whole.blue - half_b;
+
+    double score = 0.0;
+    if (half_w != 0 && other_w != 0) {
+      score = (static_cast<double>(half_r) * half_r +
+               static_cast<double>(half_g) * half_g +
+               static_cast<double>(half_b) * half_b) /
+              static_cast<double>(half_w);
+      score += (static_cast<double>(other_r) * other_r +
+                static_cast<double>(other_g) * other_g +
+                static_cast<double>(other_b) * other_b) /
+               static_cast<double>(other_w);
+    }
+    scores[i - first] = score;
+  }
+}
+
+#ifdef MCU_HAS_X86_KERNELS
+
+// The vector kernels score four cuts at a time. Each cut's moments are
+// gathered as one vector of (weight, red, green, blue), and four of them are
+// transposed into one vector per moment. 32-bit lanes wrap on overflow, so the
+// inclusion-exclusion is exact whenever its result fits in 32 bits.
+
+__attribute__((target("sse4.2"))) inline __m128i LoadBin(
+    const WuBin<int32_t>* bin) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(bin));
+}
+
+/**
+ * The four corner columns of a cut axis, copied out of the axis so that the
+ * kernels keep them in registers.
+ */
+struct Columns {
+  explicit Columns(const WuCutAxis<int32_t>& axis)
+      : c0(axis.bins + axis.corners[0]),
+        c1(axis.bins + axis.corners[1]),
+        c2(axis.bins + axis.corners[2]),
+        c3(axis.bins + axis.corners[3]),
+        stride(axis.stride) {}
+
+  const WuBin<int32_t>* c0;
+  const WuBin<int32_t>* c1;
+  const WuBin<int32_t>* c2;
+  const WuBin<int32_t>* c3;
+  int stride;
+};
+
+__attribute__((target("sse4.2"))) inline __m128i HalfMoments(
+    const Columns& columns, __m128i bottom, int i) {
+  int offset = i * columns.stride;
+  __m128i top = _mm_sub_epi32(LoadBin(columns.c0 + offset),
+                              LoadBin(columns.c1 + offset));
+  top = _mm_sub_epi32(top, LoadBin(columns.c2 + offset));
+  top = _mm_add_epi32(top, LoadBin(columns.c3 + offset));
+  return _mm_add_epi32(bottom, top);
+}
+
+/**
+ * Loads the moments of the halves cut off at positions i to i + 3, one vector
+ * per moment.
+ */
+__attribute__((target("sse4.2"))) inline void LoadHalves(
+    const Columns& columns, __m128i bottom, int i, __m128i* w, __m128i* r,
+    __m128i* g, __m128i* b) {
+  __m128 row0 = _mm_castsi128_ps(HalfMoments(columns, bottom, i));
+  __m128 row1 = _mm_castsi128_ps(HalfMoments(columns, bottom, i + 1));
+  __m128 row2 = _mm_castsi128_ps(HalfMoments(columns, bottom, i + 2));
+  __m128 row3 = _mm_castsi128_ps(HalfMoments(columns, bottom, i + 3));
+  _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+  *w = _mm_castps_si128(row0);
+  *r = _mm_castps_si128(row1);
+  *g = _mm_castps_si128(row2);
+  *b = _mm_castps_si128(row3);
+}
+
+__attribute__((target("sse4.2"))) inline __m128i Bottom(
+    const WuCutAxis<int32_t>& axis) {
+  return _mm_setr_epi32(static_cast<int32_t>(axis.bottom.weight),
+                        static_cast<int32_t>(axis.bottom.red),
+                        static_cast<int32_t>(axis.bottom.green),
+                        static_cast<int32_t>(axis.bottom.blue));
+}
+
+__attribute__((target("sse4.2"))) inline __m128d Sse42Score(__m128i w,
+                                                            __m128i r,
+                                                            __m128i g,
+                                                            __m128i b) {
+  __m128d d_r = _mm_cvtepi32_pd(r);
+  __m128d d_g = _mm_cvtepi32_pd(g);
+  __m128d d_b = _mm_cvtepi32_pd(b);
+  __m128d sum = _mm_add_pd(_mm_mul_pd(d_r, d_r), _mm_mul_pd(d_g, d_g));
+  sum = _mm_add_pd(sum, _mm_mul_pd(d_b, d_b));
+  return _mm_div_pd(sum, _mm_cvtepi32_pd(w));
+}
+
+__attribute__((target("sse4.2"))) inline __m128d Sse42Empty(__m128i w) {
+  return _mm_cmpeq_pd(_mm_cvtepi32_pd(w), _mm_setzero_pd());
+}
+
+__attribute__((target("sse4.2"))) void Sse42Scores(
+    const WuCutAxis<int32_t>& axis, int first, int last, double* scores) {
+  Columns columns(axis);
+  __m128i bottom = Bottom(axis);
+  __m128i whole_w = _mm_set1_epi32(static_cast<int32_t>(axis.whole.weight));
+  __m128i whole_r = _mm_set1_epi32(static_cast<int32_t>(axis.whole.red));
+  __m128i whole_g = _mm_set1_epi32(static_cast<int32_t>(axis.whole.green));
+  __m128i whole_b = _mm_set1_epi32(static_cast<int32_t>(axis.whole.blue));
+  int i = first;
+  for (; i + 4 <= last; i += 4) {
+    __m128i w, r, g, b;
+    LoadHalves(columns, bottom, i, &w, &r, &g, &b);
+    __m128i other_w = _mm_sub_epi32(whole_w, w);
+    __m128i other_r = _mm_sub_epi32(whole_r, r);
+    __m128i other_g = _mm_sub_epi32(whole_g, g);
+    __m128i other_b = _mm_sub_epi32(whole_b, b);
+    // Two lanes of doubles at a time: the low half of each vector, then the
+    // high half.
+    for (int j = 0; j < 2; j++) {
+      __m128d score =
+          _mm_add_pd(Sse42Score(w, r, g, b),
+                     Sse42Score(other_w, other_r, other_g, other_b));
+      __m128d empty = _mm_or_pd(Sse42Empty(w), Sse42Empty(other_w));
+      _mm_storeu_pd(scores + (i - first) + 2 * j, _mm_andnot_pd(empty, score));
+      w = _mm_srli_si128(w, 8);
+      r = _mm_srli_si128(r, 8);
+      g = _mm_srli_si128(g, 8);
+      b = _mm_srli_si128(b, 8);
+      other_w = _mm_srli_si128(other_w, 8);
+      other_r = _mm_srli_si128(other_r, 8);
+      other_g = _mm_srli_si128(other_g, 8);
+      other_b = _mm_srli_si128(other_b, 8);
+    }
+  }
+  ScalarScores(axis, i, first, last, scores);
+}
+
+__attribute__((target("avx2"))) inline __m256d Avx2Score(__m128i w,
+                                                         __m128i r,
+                                                         __m128i g,
+                                                         __m128i b) {
+  __m256d d_r = _mm256_cvtepi32_pd(r);
+  __m256d d_g = _mm256_cvtepi32_pd(g);
+  __m256d d_b = _mm256_cvtepi32_pd(b);
+  __m256d sum =
+      _mm256_add_pd(_mm256_mul_pd(d_r, d_r), _mm256_mul_pd(d_g, d_g));
+  sum = _mm256_add_pd(sum, _mm256_mul_pd(d_b, d_b));
+  return _mm256_div_pd(sum, _mm256_cvtepi32_pd(w));
+}
+
+__attribute__((target("avx2"))) inline __m256d Avx2Empty(__m128i w) {
+  return _mm256_cmp_pd(_mm256_cvtepi32_pd(w), _mm256_setzero_pd(),
+                       _CMP_EQ_OQ);
+}
+
+__attribute__((target("avx2"))) void Avx2Scores(
+    const WuCutAxis<int32_t>& axis, int first, int last, double* scores) {
+  Columns columns(axis);
+  __m128i bottom = Bottom(axis);
+  __m128i whole_w = _mm_set1_epi32(static_cast<int32_t>(axis.whole.weight));
+  __m128i whole_r = _mm_set1_epi32(static_cast<int32_t>(axis.whole.red));
+  __m128i whole_g = _mm_set1_epi32(static_cast<int32_t>(axis.whole.green));
+  __m128i whole_b = _mm_set1_epi32(static_cast<int32_t>(axis.whole.blue));
+  int i = first;
+  for (; i + 4 <= last; i += 4) {
+    __m128i w, r, g, b;
+    LoadHalves(columns, bottom, i, &w, &r, &g, &b);
+    __m128i other_w = _mm_sub_epi32(whole_w, w);
+    __m256d score = _mm256_add_pd(
+        Avx2Score(w, r, g, b),
+        Avx2Score(other_w, _mm_sub_epi32(whole_r, r),
+                  _mm_sub_epi32(whole_g, g), _mm_sub_epi32(whole_b, b)));
+    __m256d empty = _mm256_or_pd(Avx2Empty(w), Avx2Empty(other_w));
+    _mm256_storeu_pd(scores + (i - first), _mm256_andnot_pd(empty, score));
+  }
+  // The scalar tail is not VEX-encoded; clearing the upper halves first
+  // avoids a penalty on every transition.
+  _mm256_zeroupper();
+  ScalarScores(axis, i, first, last, scores);
+}
+
+#endif  // MCU_HAS_X86_KERNELS
+
+}  // namespace
+
+void ScoreWuCuts(SimdLevel level, const WuCutAxis<int32_t>& axis, int first,
+                 int last, double* scores) {
+  // Never dispatch above what the CPU supports, even if asked to.
+  if (level > BestSimdLevel()) {
+    level = BestSimdLevel();
+  }
+  switch (level) {
+#ifdef MCU_HAS_X86_KERNELS
+    case SimdLevel::kAvx2:
+      Avx2Scores(axis, first, last, scores);
+      return;
+    case SimdLevel::kSse42:
+      Sse42Scores(axis, first, last, scores);
+      return;
+#endif
+    default:
+      ScalarScores(axis, first, first, last, scores);
+      return;
+  }
+}
+
+// 64-bit moments may not fit the vector kernels' 32-bit lanes, so they are
+// always scored with scalar code, whatever the level.
+void ScoreWuCuts(SimdLevel /*level*/, const WuCutAxis<int64_t>& axis,
+                 int first, int last, double* scores) {
+  ScalarScores(axis, first, first, last, scores);
+}
+
+}  // namespace material_color_utilities
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CPP_QUANTIZE_WU_CUT_H_
+#define CPP_QUANTIZE_WU_CUT_H_
+
+#include <cstdint>
+
+#include "cpp/utils/simd.h"
+
+namespace material_color_utilities {
+
+/**
+ * One bin of the Wu quantizer's histogram: the number of pixels and the sum
+ * of each channel over them. The four moments are stored together, so that
+ * the box-cutting search reads a bin with a single load.
+ */
+template <typename Int>
+struct WuBin {
+  Int weight = 0;
+  Int red = 0;
+  Int green = 0;
+  Int blue = 0;
+};
+
+/**
+ * The cumulative moments read to score the cuts of a box along one axis.
+ *
+ * Cutting at position `i` splits off the part of the box whose moments are
+ * `bottom` plus the inclusion-exclusion of the four corner bins
+ * `bins[corners[0] + i * stride] - bins[corners[1] + i * stride] -
+ * bins[corners[2] + i * stride] + bins[corners[3] + i * stride]`.
+ * `whole` holds the moments of the entire box.
+ */
+template <typename Int>
+struct WuCutAxis {
+  const WuBin<Int>* bins;
+  int corners[4];
+  int stride;
+  WuBin<int64_t> bottom;
+  WuBin<int64_t> whole;
+};
+
+/**
+ * Scores every cut of a box along one axis, at positions `first` to
+ * `last - 1`, writing `last - first` scores. A cut scores the sum, over both
+ * halves, of the squared channel sums divided by the pixel count; a cut that
+ * leaves either half empty scores 0.
+ *
+ * Every score is computed with the same operations, in the same order, at
+ * every SimdLevel, so all levels return bit-identical scores. The vector
+ * kernels require each half's moments to fit in 32 bits, which holds for
+ * histograms that QuantizeWu stores in 32 bits; 64-bit histograms are always
+ * scored with scalar code.
+ */
+void ScoreWuCuts(SimdLevel level, const WuCutAxis<int32_t>& axis, int first,
+                 int last, double* scores);
+void ScoreWuCuts(SimdLevel level, const WuCutAxis<int64_t>& axis, int first,
+                 int last, double* scores);
+
+}  // namespace material_color_utilities
+
+#endif  // CPP_QUANTIZE_WU_CUT_H_
@@ -0,0 +1,114 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpp/quantize/wu_cut.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include "testing/base/public/gunit.h"
+#include "cpp/utils/simd.h"
+
+namespace material_color_utilities {
+
+namespace {
+
+constexpr int kBinCount = 33 * 33 * 33;
+
+std::vector<WuBin<int32_t>> RandomBins(bool empty_weights) {
+  srand(42688);
+  std::vector<WuBin<int32_t>> bins(kBinCount);
+  for (WuBin<int32_t>& bin : bins) {
+    bin.weight = empty_weights ? 0 : rand() % 1000;
+    bin.red = rand() % 255000;
+    bin.green = rand() % 255000;
+    bin.blue = rand() % 255000;
+  }
+  return bins;
+}
+
+template <typename Int>
+WuCutAxis<Int> RandomAxis(const std::vector<WuBin<Int>>& bins, int stride) {
+  WuCutAxis<Int> axis;
+  axis.bins = bins.data();
+  axis.stride = stride;
+  for (int& corner : axis.corners) {
+    corner = rand() % (kBinCount - 31 * stride);
+  }
+  axis.bottom = {rand() % 3000, rand() % 765000, rand() % 765000,
+                 rand() % 765000};
+  axis.whole = {axis.bottom.weight + rand() % 3000, rand() % 2000000,
+                rand() % 2000000, rand() % 2000000};
+  return axis;
+}
+
+template <typename Int>
+std::vector<double> Scores(SimdLevel level, const WuCutAxis<Int>& axis) {
+  // 31 cuts is deliberately not a multiple of any vector width, to cover the
+  // scalar tail of each kernel.
+  std::vector<double> scores(31);
+  ScoreWuCuts(level, axis, 1, 32, scores.data());
+  return scores;
+}
+
+TEST(WuCutTest, KernelsMatchScalarExactly) {
+  std::vector<WuBin<int32_t>> bins = RandomBins(false);
+  for (int stride : {1, 33, 33 * 33}) {
+    for (int trial = 0; trial < 20; trial++) {
+      WuCutAxis<int32_t> axis = RandomAxis(bins, stride);
+      std::vector<double> expected = Scores(SimdLevel::kScalar, axis);
+      for (SimdLevel level : {SimdLevel::kSse42, SimdLevel::kAvx2}) {
+        EXPECT_EQ(Scores(level, axis), expected) << SimdLevelName(level);
+      }
+    }
+  }
+}
+
+TEST(WuCutTest, WideBinsMatchNarrowBins) {
+  std::vector<WuBin<int32_t>> bins = RandomBins(false);
+  std::vector<WuBin<int64_t>> wide_bins;
+  for (const WuBin<int32_t>& bin : bins) {
+    wide_bins.push_back({bin.weight, bin.red, bin.green, bin.blue});
+  }
+  WuCutAxis<int32_t> axis = RandomAxis(bins, 33);
+  WuCutAxis<int64_t> wide_axis;
+  wide_axis.bins = wide_bins.data();
+  wide_axis.stride = axis.stride;
+  for (int i = 0; i < 4; i++) {
+    wide_axis.corners[i] = axis.corners[i];
+  }
+  wide_axis.bottom = axis.bottom;
+  wide_axis.whole = axis.whole;
+  EXPECT_EQ(Scores(SimdLevel::kAvx2, wide_axis),
+            Scores(SimdLevel::kAvx2, axis));
+}
+
+TEST(WuCutTest, EmptyHalvesScoreZero) {
+  std::vector<WuBin<int32_t>> bins = RandomBins(true);
+  WuCutAxis<int32_t> axis = RandomAxis(bins, 1);
+  axis.bottom.weight = 0;
+  axis.whole.weight = 0;
+  for (SimdLevel level :
+       {SimdLevel::kScalar, SimdLevel::kSse42, SimdLevel::kAvx2}) {
+    for (double score : Scores(level, axis)) {
+      EXPECT_EQ(score, 0.0) << SimdLevelName(level);
+    }
+  }
+}
+
+}  // namespace
+}  // namespace material_color_utilities
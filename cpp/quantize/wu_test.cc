@@ -20,6 +20,8 @@
 #include <vector>
 
 #include "testing/base/public/gunit.h"
+#include "absl/types/span.h"
+#include "cpp/quantize/pixel_view.h"
 
 namespace material_color_utilities {
 
@@ -112,5 +114,179 @@ TEST(WuTest, Testonly) {
   std::vector<Argb> result = QuantizeWu(pixels, 256);
 }
 
+TEST(WuTest, WorkspaceReuseMatchesFreshCalls) {
+  WuWorkspace workspace;
+  for (int index_bits : {5, 4, 6, 5}) {
+    for (size_t size : {12544, 100, 40000}) {
+      std::vector<Argb> pixels(size);
+      for (size_t i = 0; i < pixels.size(); i++) {
+        pixels[i] = 0xff000000 | ((i * 2654435761u) & 0xffffff);
+      }
+      WuOptions options;
+      options.index_bits = index_bits;
+      EXPECT_EQ(QuantizeWu(pixels, 128, options, &workspace),
+                QuantizeWu(pixels, 128, options));
+    }
+  }
+}
+
+TEST(WuTest, DefaultIndexBitsMatchWuHistogram) {
+  std::vector<Argb> pixels(12544);
+  for (size_t i = 0; i < pixels.size(); i++) {
+    pixels[i] = 0xff000000 | ((i * 2654435761u) & 0xffffff);
+  }
+  WuHistogram histogram;
+  histogram.Add(pixels);
+  WuWorkspace workspace;
+  EXPECT_EQ(QuantizeWu(pixels, 128, WuOptions(), &workspace),
+            histogram.Quantize(128));
+}
+
+TEST(WuTest, RedGreenBlueAtEveryIndexBits) {
+  std::vector<Argb> pixels = {0xffff0000, 0xff00ff00, 0xff0000ff};
+  for (int index_bits : {4, 5, 6}) {
+    WuOptions options;
+    options.index_bits = index_bits;
+    std::vector<Argb> result = QuantizeWu(pixels, 256, options);
+    ASSERT_EQ(result.size(), 3u);
+    EXPECT_EQ(result[0], 0xff0000ff);
+    EXPECT_EQ(result[1], 0xffff0000);
+    EXPECT_EQ(result[2], 0xff00ff00);
+  }
+}
+
+TEST(WuTest, MoreIndexBitsSeparateSimilarColors) {
+  // These fall in the same bin at 4 bits per channel, but not at 6.
+  std::vector<Argb> pixels = {0xff404040, 0xff444444};
+  WuOptions options;
+  options.index_bits = 4;
+  EXPECT_EQ(QuantizeWu(pixels, 256, options).size(), 1u);
+  options.index_bits = 6;
+  EXPECT_EQ(QuantizeWu(pixels, 256, options).size(), 2u);
+}
+
+TEST(WuTest, LargeImageDoesNotOverflowMoments) {
+  // Enough white pixels that channel sums need more than 32 bits.
+  std::vector<Argb> pixels(9000000, 0xffffffff);
+  pixels.resize(pixels.size() + 1000000, 0xff000000);
+  std::vector<Argb> result = QuantizeWu(pixels, 16);
+  ASSERT_EQ(result.size(), 2u);
+  EXPECT_EQ(result[0], 0xff000000);
+  EXPECT_EQ(result[1], 0xffffffff);
+
+  WuOptions options;
+  options.num_threads = 4;
+  EXPECT_EQ(QuantizeWu(pixels, 16, options), result);
+}
+
+TEST(WuTest, ThreadsMatchOneThread) {
+  // Large enough to be split across threads, by rows for the image and by
+  // columns for the single row of pixels.
+  constexpr int kWidth = 1800;
+  constexpr int kHeight = 1200;
+  std::vector<Argb> pixels(kWidth * kHeight);
+  for (size_t i = 0; i < pixels.size(); i++) {
+    pixels[i] = 0xff000000 | ((i * 2654435761u) & 0xffffff);
+    if (i % 7 == 0) {
+      pixels[i] &= 0x80ffffff;
+    }
+  }
+  PixelView image(pixels.data(), kWidth, kHeight, kWidth * sizeof(Argb),
+                  PixelFormat::kArgb);
+  image.opaque_only = true;
+  PixelView row(pixels);
+
+  WuWorkspace workspace;
+  for (int index_bits : {4, 5, 6}) {
+    WuOptions options;
+    options.index_bits = index_bits;
+    std::vector<Argb> expected_image = QuantizeWu(image, 128, options);
+    std::vector<Argb> expected_row = QuantizeWu(row, 128, options);
+    for (int num_threads : {2, 3, 16}) {
+      options.num_threads = num_threads;
+      EXPECT_EQ(QuantizeWu(image, 128, options, &workspace), expected_image)
+          << index_bits << " bits, " << num_threads << " threads";
+      EXPECT_EQ(QuantizeWu(row, 128, options, &workspace), expected_row)
+          << index_bits << " bits, " << num_threads << " threads";
+    }
+  }
+}
+
+TEST(WuTest, BgraViewMatchesArgbPixels) {
+  std::vector<Argb> pixels(100 * 50);
+  for (size_t i = 0; i < pixels.size(); i++) {
+    pixels[i] = 0xff000000 | ((i * 2654435761u) & 0xffffff);
+  }
+  constexpr size_t kStride = 100 * 4 + 12;
+  std::vector<uint8_t> bgra(kStride * 50);
+  for (int y = 0; y < 50; y++) {
+    for (int x = 0; x < 100; x++) {
+      Argb argb = pixels[y * 100 + x];
+      uint8_t* bytes = &bgra[y * kStride + 4 * x];
+      bytes[0] = argb & 0xff;
+      bytes[1] = (argb >> 8) & 0xff;
+      bytes[2] = (argb >> 16) & 0xff;
+      bytes[3] = argb >> 24;
+    }
+  }
+  PixelView view(bgra.data(), 100, 50, kStride, PixelFormat::kBgra8888);
+  EXPECT_EQ(QuantizeWu(view, 128), QuantizeWu(pixels, 128));
+
+  WuHistogram histogram;
+  histogram.Add(view);
+  EXPECT_EQ(histogram.pixel_count(), 5000);
+  EXPECT_EQ(histogram.Quantize(128), QuantizeWu(pixels, 128));
+}
+
+TEST(WuTest, OpaqueOnlyViewSkipsTransparentPixels) {
+  std::vector<Argb> pixels = {0xffff0000, 0x00000000, 0x8000ff00,
+                              0xff0000ff};
+  PixelView view(pixels);
+  view.opaque_only = true;
+  EXPECT_EQ(QuantizeWu(view, 256),
+            QuantizeWu(std::vector<Argb>({0xffff0000, 0xff0000ff}), 256));
+  WuHistogram histogram;
+  histogram.Add(view);
+  EXPECT_EQ(histogram.pixel_count(), 2);
+}
+
+TEST(WuHistogramTest, TilesMatchWholeImage) {
+  std::vector<Argb> pixels(12544);
+  for (size_t i = 0; i < pixels.size(); i++) {
+    pixels[i] = 0xff000000 | ((i * 2654435761u) & 0xffffff);
+  }
+  WuHistogram histogram;
+  absl::Span<const Argb> remaining(pixels);
+  while (!remaining.empty()) {
+    absl::Span<const Argb> tile = remaining.subspan(0, 1000);
+    histogram.Add(tile);
+    remaining.remove_prefix(tile.size());
+  }
+  EXPECT_EQ(histogram.pixel_count(), 12544);
+  EXPECT_EQ(histogram.Quantize(128), QuantizeWu(pixels, 128));
+  // Quantizing leaves the histogram intact.
+  EXPECT_EQ(histogram.Quantize(16), QuantizeWu(pixels, 16));
+}
+
+TEST(WuHistogramTest, MergeMatchesWholeImage) {
+  std::vector<Argb> pixels(12544);
+  for (size_t i = 0; i < pixels.size(); i++) {
+    pixels[i] = 0xff000000 | ((i * 2654435761u) & 0xffffff);
+  }
+  absl::Span<const Argb> all(pixels);
+  WuHistogram first;
+  first.Add(all.subspan(0, 5000));
+  WuHistogram second;
+  second.Add(all.subspan(5000));
+  first.Merge(second);
+  EXPECT_EQ(first.pixel_count(), 12544);
+  EXPECT_EQ(first.Quantize(128), QuantizeWu(pixels, 128));
+}
+
+TEST(WuHistogramTest, Empty) {
+  WuHistogram histogram;
+  EXPECT_TRUE(histogram.Quantize(128).empty());
+}
+
 }  // namespace
 }  // namespace material_color_utilities
@@ -17,6 +17,7 @@
 #include "cpp/score/score.h"
 
 #include <algorithm>
+#include <cassert>
 #include <cmath>
 #include <cstdint>
 #include <map>
@@ -43,13 +44,37 @@ bool CompareScoredHCT(const std::pair<Hct, double>& a,
 std::vector<Argb> RankedSuggestions(
     const std::map<Argb, uint32_t>& argb_to_population,
     const ScoreOptions& options) {
+  std::vector<Argb> colors;
+  std::vector<uint32_t> populations;
+  colors.reserve(argb_to_population.size());
+  populations.reserve(argb_to_population.size());
+  for (const auto& [argb, population] : argb_to_population) {
+    colors.push_back(argb);
+    populations.push_back(population);
+  }
+  return RankedSuggestions(colors, populations, options);
+}
+
+namespace {
+
+/**
+ * RankedSuggestions for populations of type T: whole pixel counts, or
+ * fractional weights.
+ */
+template <typename T>
+std::vector<Argb> RankColors(absl::Span<const Argb> colors,
+                             absl::Span<const T> populations,
+                             const ScoreOptions& options) {
+  assert(colors.size() == populations.size());
   // Get the HCT color for each Argb value, while finding the per hue count and
   // total count.
   std::vector<Hct> colors_hct;
-  std::vector<uint32_t> hue_population(360, 0);
+  colors_hct.reserve(colors.size());
+  std::vector<T> hue_population(360, 0);
   double population_sum = 0;
-  for (const auto& [argb, population] : argb_to_population) {
-    Hct hct(argb);
+  for (size_t i = 0; i < colors.size(); i++) {
+    T population = populations[i];
+    Hct hct(colors[i]);
     colors_hct.push_back(hct);
     int hue = floor(hct.get_hue());
     hue_population[hue] += population;
@@ -111,14 +136,28 @@ std::vector<Argb> RankedSuggestions(
     }
     if (chosen_colors.size() >= options.desired) break;
   }
-  std::vector<Argb> colors;
+  std::vector<Argb> ranked_colors;
   if (chosen_colors.empty()) {
-    colors.push_back(options.fallback_color_argb);
+    ranked_colors.push_back(options.fallback_color_argb);
   }
   for (auto chosen_hct : chosen_colors) {
-    colors.push_back(chosen_hct.ToInt());
+    ranked_colors.push_back(chosen_hct.ToInt());
   }
-  return colors;
+  return ranked_colors;
+}
+
+}  // namespace
+
+std::vector<Argb> RankedSuggestions(absl::Span<const Argb> colors,
+                                    absl::Span<const uint32_t> populations,
+                                    const ScoreOptions& options) {
+  return RankColors(colors, populations, options);
+}
+
+std::vector<Argb> RankedSuggestions(absl::Span<const Argb> colors,
+                                    absl::Span<const double> weights,
+                                    const ScoreOptions& options) {
+  return RankColors(colors, weights, options);
 }
 
 }  // namespace material_color_utilities
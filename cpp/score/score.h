@@ -21,6 +21,7 @@
 #include <map>
 #include <vector>
 
+#include "absl/types/span.h"
 #include "cpp/utils/utils.h"
 
 namespace material_color_utilities {
@@ -54,6 +55,27 @@ struct ScoreOptions {
 std::vector<Argb> RankedSuggestions(
     const std::map<Argb, uint32_t>& argb_to_population,
     const ScoreOptions& options = {});
+
+/**
+ * Variant of RankedSuggestions that takes colors and their populations as
+ * parallel arrays, such as the `colors` and `populations` of a
+ * FlatQuantizerResult, which must have the same length. Colors should be in
+ * ascending order to rank ties the same way as the map overload.
+ */
+std::vector<Argb> RankedSuggestions(absl::Span<const Argb> colors,
+                                    absl::Span<const uint32_t> populations,
+                                    const ScoreOptions& options = {});
+
+/**
+ * Variant of RankedSuggestions that takes fractional populations, such as the
+ * `weights` of a FlatQuantizerResult quantized from weighted colors. Only
+ * their proportions matter, so weights normalized to sum to 1 rank the same
+ * as the pixel counts they are proportional to. `colors` and `weights` must
+ * have the same length.
+ */
+std::vector<Argb> RankedSuggestions(absl::Span<const Argb> colors,
+                                    absl::Span<const double> weights,
+                                    const ScoreOptions& options = {});
 }  // namespace material_color_utilities
 
 #endif  // CPP_SCORE_SCORE_H_
@@ -51,6 +51,29 @@ TEST(ScoreTest, PrioritizesChromaWhenProportionsEqual) {
   EXPECT_EQ(ranked[2], 0xff0000ff);
 }
 
+TEST(ScoreTest, ArraysMatchMap) {
+  std::map<Argb, uint32_t> argb_to_population = {
+      {0xff008772, 1}, {0xff318477, 2}, {0xffa08f5d, 3}, {0xffe75b4a, 4}};
+  std::vector<Argb> colors;
+  std::vector<uint32_t> populations;
+  for (const auto& [argb, population] : argb_to_population) {
+    colors.push_back(argb);
+    populations.push_back(population);
+  }
+
+  EXPECT_EQ(RankedSuggestions(colors, populations),
+            RankedSuggestions(argb_to_population));
+}
+
+TEST(ScoreTest, NormalizedWeightsMatchCounts) {
+  std::vector<Argb> colors = {0xff008772, 0xff318477, 0xffa08f5d, 0xffe75b4a};
+  std::vector<uint32_t> populations = {1, 2, 3, 4};
+  std::vector<double> weights = {0.1, 0.2, 0.3, 0.4};
+
+  EXPECT_EQ(RankedSuggestions(colors, weights),
+            RankedSuggestions(colors, populations));
+}
+
 TEST(ScoreTest, GeneratesGblueWhenNoColorsAvailable) {
   std::map<Argb, uint32_t> argb_to_population = {{0xff000000, 1}};
 
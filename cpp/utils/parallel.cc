@@ -0,0 +1,140 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpp/utils/parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace material_color_utilities {
+
+namespace {
+
+/**
+ * One call to ParallelFor. Indices are claimed from `next_index` by the
+ * calling thread and by any pool threads that pick the job up.
+ * `finished`: number of indices whose call has returned.
+ */
+struct Job {
+  Job(int count, const std::function<void(int)>& fn) : count(count), fn(fn) {}
+
+  const int count;
+  const std::function<void(int)>& fn;
+  std::atomic<int> next_index{0};
+  std::atomic<int> finished{0};
+  std::mutex mutex;
+  std::condition_variable all_finished;
+
+  /**
+   * Runs indices until none are left to claim.
+   */
+  void Work() {
+    for (int i = next_index++; i < count; i = next_index++) {
+      fn(i);
+      if (++finished == count) {
+        std::lock_guard<std::mutex> lock(mutex);
+        all_finished.notify_all();
+      }
+    }
+  }
+};
+
+/**
+ * Threads shared by every ParallelFor call in the process, started on first
+ * use and kept waiting for work, so that callers which run many short
+ * parallel loops, such as each WSMeans iteration, do not start and join
+ * threads every time.
+ *
+ * The caller of ParallelFor always works on its own job as well, and a job
+ * is done once its indices are, whether or not pool threads reached it. So
+ * calls never wait on a busy pool, and ParallelFor may be called from
+ * several threads at once, or from inside another call's `fn`.
+ */
+class ThreadPool {
+ public:
+  static ThreadPool& Get() {
+    // Never destroyed, since its threads may still be waiting at exit.
+    static ThreadPool* pool = new ThreadPool();
+    return *pool;
+  }
+
+  /**
+   * Offers `job` to up to `helper_count` pool threads, starting more threads
+   * if the pool has fewer. The pool never holds more threads than the
+   * hardware runs at once, since they are never retired.
+   */
+  void Post(const std::shared_ptr<Job>& job, int helper_count) {
+    helper_count = std::min(helper_count, max_thread_count_);
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (; thread_count_ < helper_count; thread_count_++) {
+      std::thread([this]() { Run(); }).detach();
+    }
+    for (int i = 0; i < helper_count; i++) {
+      pending_.push_back(job);
+    }
+    work_available_.notify_all();
+  }
+
+ private:
+  void Run() {
+    while (true) {
+      std::shared_ptr<Job> job;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        work_available_.wait(lock, [this]() { return !pending_.empty(); });
+        job = std::move(pending_.front());
+        pending_.pop_front();
+      }
+      job->Work();
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable work_available_;
+  std::deque<std::shared_ptr<Job>> pending_;
+  const int max_thread_count_ =
+      std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  int thread_count_ = 0;
+};
+
+}  // namespace
+
+void ParallelFor(int num_threads, int count,
+                 const std::function<void(int)>& fn) {
+  int worker_count = std::min(num_threads, count);
+  if (worker_count <= 1) {
+    for (int i = 0; i < count; i++) {
+      fn(i);
+    }
+    return;
+  }
+
+  // Pool threads that reach the job after its last index has been claimed
+  // find nothing to do, but may still hold it, so it is shared with them.
+  auto job = std::make_shared<Job>(count, fn);
+  ThreadPool::Get().Post(job, worker_count - 1);
+  job->Work();
+  std::unique_lock<std::mutex> lock(job->mutex);
+  job->all_finished.wait(lock, [&]() { return job->finished == count; });
+}
+
+}  // namespace material_color_utilities
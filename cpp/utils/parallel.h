@@ -0,0 +1,46 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CPP_UTILS_PARALLEL_H_
+#define CPP_UTILS_PARALLEL_H_
+
+#include <functional>
+
+namespace material_color_utilities {
+
+/**
+ * Calls `fn(i)` once for every i in [0, count), spread across up to
+ * `num_threads` threads, and returns when all calls have finished.
+ *
+ * The order in which indices run is unspecified, so callers that need
+ * deterministic output should write results to per-index storage and combine
+ * them in index order afterwards.
+ *
+ * Indices run on the calling thread and on threads from a pool shared by all
+ * calls, which are started when first needed and then reused for the rest
+ * of the process. The pool holds at most as many threads as the hardware
+ * runs at once, however large `num_threads` is. Calls may be made from
+ * several threads at once, and from inside `fn`.
+ *
+ * @param num_threads Maximum number of threads, including the calling thread.
+ * Values below 2 run every index on the calling thread.
+ */
+void ParallelFor(int num_threads, int count,
+                 const std::function<void(int)>& fn);
+
+}  // namespace material_color_utilities
+
+#endif  // CPP_UTILS_PARALLEL_H_
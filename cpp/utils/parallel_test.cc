@@ -0,0 +1,71 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpp/utils/parallel.h"
+
+#include <atomic>
+#include <vector>
+
+#include "testing/base/public/gunit.h"
+
+namespace material_color_utilities {
+
+namespace {
+
+TEST(ParallelForTest, RunsEveryIndexOnce) {
+  for (int num_threads : {0, 1, 2, 7}) {
+    std::vector<std::atomic<int>> calls(100);
+    ParallelFor(num_threads, calls.size(), [&](int i) { calls[i]++; });
+    for (const std::atomic<int>& count : calls) {
+      EXPECT_EQ(count.load(), 1);
+    }
+  }
+}
+
+TEST(ParallelForTest, MoreThreadsThanHardware) {
+  std::vector<std::atomic<int>> calls(2000);
+  ParallelFor(1000, calls.size(), [&](int i) { calls[i]++; });
+  for (const std::atomic<int>& count : calls) {
+    EXPECT_EQ(count.load(), 1);
+  }
+}
+
+TEST(ParallelForTest, EmptyRange) {
+  int calls = 0;
+  ParallelFor(4, 0, [&](int) { calls++; });
+  EXPECT_EQ(calls, 0);
+}
+
+TEST(ParallelForTest, NestedCalls) {
+  std::vector<std::atomic<int>> calls(8 * 50);
+  ParallelFor(4, 8, [&](int outer) {
+    ParallelFor(4, 50, [&](int inner) { calls[outer * 50 + inner]++; });
+  });
+  for (const std::atomic<int>& count : calls) {
+    EXPECT_EQ(count.load(), 1);
+  }
+}
+
+TEST(ParallelForTest, ManyShortCalls) {
+  std::atomic<int> calls(0);
+  for (int i = 0; i < 1000; i++) {
+    ParallelFor(8, 16, [&](int) { calls++; });
+  }
+  EXPECT_EQ(calls.load(), 16000);
+}
+
+}  // namespace
+}  // namespace material_color_utilities
@@ -0,0 +1,50 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CPP_UTILS_SIMD_H_
+#define CPP_UTILS_SIMD_H_
+
+// Defined when kernels for x86 instruction sets can be compiled with
+// per-function target attributes and selected at run time.
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define MCU_HAS_X86_KERNELS 1
+#endif
+
+namespace material_color_utilities {
+
+/**
+ * Instruction sets that kernels can be dispatched to.
+ */
+enum class SimdLevel {
+  kScalar,
+  kSse42,
+  kAvx2,
+};
+
+/**
+ * Returns the widest instruction set supported by the running CPU. Detected
+ * once and cached.
+ */
+SimdLevel BestSimdLevel();
+
+/**
+ * Returns a short name for a SimdLevel, e.g. "avx2".
+ */
+const char* SimdLevelName(SimdLevel level);
+
+}  // namespace material_color_utilities
+
+#endif  // CPP_UTILS_SIMD_H_
@@ -59,7 +59,102 @@ int Delinearized(const double rgb_component) {
   return std::clamp((int)round(delinearized * 255.0), 0, 255);
 }
 
+/**
+ * Linearized() of every valid RGB component, precomputed.
+ */
+constexpr double kLinearizedComponents[256] = {
+    0.0,                  0.030352698354883752, 0.060705396709767503,
+    0.091058095064651248, 0.12141079341953501,  0.15176349177441875,
+    0.1821161901293025,   0.21246888848418627,  0.24282158683907001,
+    0.2731742851939537,   0.3035269835488375,   0.33465357638991611,
+    0.36765073240474361,  0.40247170184963066,  0.43914420374102936,
+    0.47769534806937292,  0.51815167023383857,  0.56053916242027224,
+    0.60488330228570542,  0.65120907925944749,  0.69954101872653873,
+    0.74990320432261748,  0.80231929853849948,  0.85681256180693066,
+    0.91340587022207875,  0.97212173202378493,  1.0329823029626937,
+    1.0960094006488246,   1.1612245179743885,   1.2286488356915872,
+    1.2983032342173013,   1.3702083047289686,   1.4443843596092545,
+    1.5208514422912709,   1.5996293365509631,   1.6807375752887384,
+    1.7641954488384077,   1.8500220128379696,   1.9382360956935722,
+    2.02885630566524,     2.1219010376003555,   2.2173884793387382,
+    2.3153366178110408,   2.4157632448504756,   2.5186859627361629,
+    2.6241221894849898,   2.7320891639074896,   2.8426039504420793,
+    2.9556834437808801,   3.0713443732993633,   3.1896033073011534,
+    3.3104766570885054,   3.433980680868217,    3.5601314875020345,
+    3.6889450401100041,   3.82043715953465,     3.9546235276732835,
+    4.0915196906853186,   4.2311410620809671,   4.3735029256973466,
+    4.5186204385675541,   4.6665086336880091,   4.8171824226889415,
+    4.9706565984127229,   5.1269458374043237,   5.2860647023180247,
+    5.4480276442442372,   5.612849004960009,    5.7805430191067231,
+    5.9511238162981197,   6.1246054231617606,   6.3010017653167676,
+    6.4803266692905774,   6.6625938643772891,   6.8478169844400165,
+    7.0360095696595879,   7.2271850682317478,   7.4213568380149626,
+    7.618538148130785,    7.8187421805186323,   8.0219820314468322,
+    8.2282707129814803,   8.4376211544148809,   8.650046203654977,
+    8.8655586285772934,   9.0841711183407678,   9.3058962846687443,
+    9.5307466630964708,   9.7587347141862466,   9.989872824711389,
+    10.224173308810132,   10.461648409110419,   10.702310297826761,
+    10.946171077829932,   11.193242783690561,   11.443537382697373,
+    11.697066775851084,   11.953842798834561,   12.213877222960187,
+    12.47718175609505,    12.743768043564744,   13.013647669036429,
+    13.286832155381797,   13.563332965520566,   13.843161503245183,
+    14.126329114027165,   14.412847085805778,   14.702726649759498,
+    14.995978981060857,   15.292615199615017,   15.59264637078274,
+    15.89608350608804,    16.2029375639111,     16.513219450166762,
+    16.826940018969076,   17.14411007328226,    17.464740365558505,
+    17.788841598362911,   18.116424424986022,   18.447499450044099,
+    18.782077230067788,   19.120168274079138,   19.461783044157581,
+    19.806931955994887,   20.155625379439705,   20.507873639031693,
+    20.863687014525574,   21.223075741405523,   21.586050011389926,
+    21.952619972926922,   22.322795731680849,   22.696587351009835,
+    23.074004852434914,   23.455058216100522,   23.839757381227102,
+    24.228112246555487,   24.620132670783548,   25.015828472995345,
+    25.415209433082676,   25.818285292159583,   26.225065752969623,
+    26.635560480286248,   27.04977910130658,    27.467731206038465,
+    27.889426347681042,   28.314874042999211,   28.744083772691749,
+    29.177064981753588,   29.613827079832113,   30.054379441577652,
+    30.498731406988629,   30.946892281750856,   31.398871337571755,
+    31.854677812509184,   32.314320911295077,   32.777809805654215,
+    33.245153634617935,   33.716361504833039,   34.191442490866095,
+    34.670405635502959,   35.153259950043939,   35.640014414594354,
+    36.130677978350953,   36.625259559883951,   37.123768047414913,
+    37.626212299090653,   38.132601143253012,   38.642943378704899,
+    39.157247774972326,   39.675523072562683,   40.197777983219581,
+    40.724021190173673,   41.254261348390372,   41.788507084813745,
+    42.32676699860717,    42.869049661390662,   43.415363617474895,
+    43.965717384091882,   44.520119451622783,   45.078578283822345,
+    45.641102318040467,   46.20769996544071,    46.778379611215897,
+    47.353149614800955,   47.932018310082682,   48.514994005607036,
+    49.102084984783559,   49.693299506087044,   50.28864580325687,
+    50.888132085493375,   51.49176653765214,    52.09955732043543,
+    52.711512570581306,   53.327640401050523,   53.947948901210715,
+    54.572446137018659,   55.201140151200015,   55.834038963426792,
+    56.471150570492924,   57.112482946487312,   57.758044042965061,
+    58.407841789116411,   59.061884091933692,   59.720178836376334,
+    60.382733885533781,   61.049557080786478,   61.720656241965109,
+    62.39603916750761,    63.075713634614686,   63.759687399403262,
+    64.447968197058216,   65.140563741982419,   65.837481727944848,
+    66.538729828227204,   67.244315695768748,   67.954246963309387,
+    68.668531243531348,   69.387176129198991,   70.110189193297316,
+    70.837577989168679,   71.569350050648069,   72.30551289219693,
+    73.046074009035365,   73.79104087727309,    74.540420954038751,
+    75.29422167760778,    76.052450467529241,   76.8151147247507,
+    77.582221831742359,   78.353779152619353,   79.129794033263025,
+    79.910273801440894,   80.695225766925162,   81.484657221610121,
+    82.278575439628355,   83.076987677465468,   83.879901174074007,
+    84.687323150985804,   85.499260812423387,   86.315721345410239,
+    87.136711919879716,   87.962239688783171,   88.792311788196628,
+    89.626935337426644,   90.466117439114953,   91.309865179341926,
+    92.158185627729466,   93.011085837542367,   93.868572845788805,
+    94.730653673319992,   95.597335324928608,   96.468624789446508,
+    97.344529039841248,   98.225055033311719,   99.110209711382979,
+    100.0,
+};
+
 double Linearized(const int rgb_component) {
+  if (0 <= rgb_component && rgb_component <= 255) {
+    return kLinearizedComponents[rgb_component];
+  }
   double normalized = rgb_component / 255.0;
   if (normalized <= 0.040449936) {
     return normalized / 12.92 * 100.0;